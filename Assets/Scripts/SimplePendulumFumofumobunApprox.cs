@@ -21,6 +21,16 @@ namespace SimplePendulum
         /// </summary>
         private static readonly Vector3 GravityDirection = Physics.gravity.normalized;
 
+        /// <summary>
+        /// アルミニウムの密度（kg/m^3）
+        /// </summary>
+        private const Double AluminiumRho = 2698.9;
+
+        /// <summary>
+        /// 重力加速度
+        /// </summary>
+        private const Double G = 9.80665;
+
         /// <summary>
         /// ロープの重心のスケール
         /// </summary>
@@ -32,6 +42,11 @@ namespace SimplePendulum
         /// </summary>
         private float firsttheta;
 
+        /// <summary>
+        /// 球の質量
+        /// </summary>
+        private Double mass;
+
         /// <summary>
         /// 原点の座標
         /// </summary>
@@ -99,6 +114,16 @@ namespace SimplePendulum
             return theta * (this.GetSpherePosZ() > 0.0f ? 1.0f : -1.0f);
         }
 
+        /// <summary>
+        /// 運動エネルギーを求める
+        /// </summary>
+        /// <param name="v">速度</param>
+        /// <returns>運動エネルギー</returns>
+        private float KineticEnergy(float v)
+        {
+            return (float)(0.5 * this.mass * v * v);
+        }
+
         /// <summary>
         /// GUIイベントの処理
         /// </summary>
@@ -123,13 +148,16 @@ namespace SimplePendulum
                 String.Format("@fumofumobunさんの近似関数による角度θ = {0:F3}°", this.GetThetaDeg()),
                 guiStyle);
 
+            var v = Solveeomcs.SolveEoMcs.GetV_Fumofumobun_Approx();
+
             // ラベルに近似関数による速度vの値を表示する
             GUI.Label(
                 new Rect(20.0f, 100.0f, 450.0f, 20.0f),
-                String.Format("@fumofumobunさんの近似関数による速度v = {0:F3}(m/s)", Solveeomcs.SolveEoMcs.GetV_Fumofumobun_Approx()),
+                String.Format("@fumofumobunさんの近似関数による速度v = {0:F3}(m/s)", v),
                 guiStyle);
 
-            var kinetic = Solveeomcs.SolveEoMcs.Kinetic_Energy(Solveeomcs.SolveEoMcs.GetV_Fumofumobun_Approx());
+            // OnGUIは1フレームに何度も呼ばれるので、エネルギーはネイティブ関数を呼ばずにC#で求める
+            var kinetic = this.KineticEnergy(v);
 
             // ラベルに近似関数による運動エネルギーの値を表示する
             GUI.Label(
@@ -137,7 +165,7 @@ namespace SimplePendulum
                 String.Format("@fumofumobunさんの近似関数による運動エネルギー = {0:F3}(J)", kinetic),
                 guiStyle);
 
-            var potential = Solveeomcs.SolveEoMcs.Potential_Energy(Solveeomcs.SolveEoMcs.GetTheta_Fumofumobun_Approx());
+            var potential = this.PotentialEnergy(Solveeomcs.SolveEoMcs.GetTheta_Fumofumobun_Approx());
 
             // ラベルに近似関数によるポテンシャルエネルギーの値を表示する
             GUI.Label(
@@ -164,6 +192,16 @@ namespace SimplePendulum
             }
         }
 
+        /// <summary>
+        /// ポテンシャルエネルギーを求める
+        /// </summary>
+        /// <param name="theta">角度</param>
+        /// <returns>ポテンシャルエネルギー</returns>
+        private float PotentialEnergy(float theta)
+        {
+            return (float)(this.mass * SimplePendulumFumofumobunApprox.G * this.ropeLength * (1.0 - Math.Cos(theta)));
+        }
+
         /// <summary>
         /// 角度θを指定して、時刻0の状態に戻す
         /// </summary>
@@ -259,6 +297,9 @@ namespace SimplePendulum
         {
             this.ropeLength = Vector3.Distance(this.origin, this.sphere.transform.position);
 
+            // ネイティブ側のSolveEoMと同じく、アルミニウムの球として質量を求める
+            this.mass = 4.0 / 3.0 * Math.PI * this.radius * this.radius * this.radius * SimplePendulumFumofumobunApprox.AluminiumRho;
+
             this.firsttheta = Mathf.Deg2Rad * this.GetThetaDeg();
         }
 
@@ -0,0 +1,778 @@
+﻿/*! \file bulirschstoer.h
+    \brief 作業領域を全て固定長配列で持つBulirsch-Stoer法のクラスの宣言と実装
+
+    Copyright © 2016-2018 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+#ifndef _BULIRSCHSTOER_H_
+#define _BULIRSCHSTOER_H_
+
+#pragma once
+
+#include <algorithm>    // for std::max, std::min
+#include <array>        // for std::array
+#include <cmath>        // for std::fabs, std::pow
+#include <cstddef>      // for std::size_t
+#include <limits>       // for std::numeric_limits
+#include <stdexcept>    // for std::runtime_error
+#include <type_traits>  // for std::false_type, std::true_type, std::void_t
+#include <utility>      // for std::index_sequence, std::make_index_sequence
+
+namespace solveeom {
+    //! A template struct.
+    /*!
+        型Tがアロケータを持つ（allocator_typeを定義している）かどうか
+        \tparam T 調べる型
+    */
+    template <typename T, typename = void>
+    struct has_allocator : std::false_type {};
+
+    //! A template struct (partial specialization).
+    /*!
+        型Tがアロケータを持つ場合
+        \tparam T 調べる型
+    */
+    template <typename T>
+    struct has_allocator<T, std::void_t<typename T::allocator_type>> : std::true_type {};
+
+    //! A template class.
+    /*!
+        Bulirsch-Stoer法で常微分方程式を解くクラス
+        boost::numeric::odeint::bulirsch_stoerと同じアルゴリズム・同じ演算順序で実装し、同じ結果を返す
+        ただし作業領域を全て状態と同じ型で持つため、構築後はヒープ領域を一切確保しない
+        実行時に大きさが決まる状態では、作業領域は構築時に状態と同じアロケータから確保される
+        \tparam State 状態の型（std::array<double, N>、または実行時に大きさが決まるstd::vector<double>、std::pmr::vector<double>）
+    */
+    template <typename State>
+    class BulirschStoer final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param eps_abs 許容絶対誤差
+            \param eps_rel 許容相対誤差
+        */
+        BulirschStoer(double eps_abs, double eps_rel);
+
+        //! A constructor.
+        /*!
+            作業領域の大きさとアロケータを状態xに合わせるコンストラクタ
+            実行時に大きさが決まる状態（std::vector<double>、std::pmr::vector<double>）では、こちらを用いなければならない
+            \param eps_abs 許容絶対誤差
+            \param eps_rel 許容相対誤差
+            \param x 状態（大きさだけが用いられる）
+        */
+        BulirschStoer(double eps_abs, double eps_rel, State const & x);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~BulirschStoer() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        //! A public member function (template function).
+        /*!
+            時刻t0からt1まで、刻み幅を自動調整しながら積分する
+            次数と刻み幅の推定値は呼び出しの最初に初期状態に戻される
+            \param system 運動方程式
+            \param x 状態（積分結果で上書きされる）
+            \param t0 開始時刻
+            \param t1 終了時刻
+            \param dt 初期刻み幅
+            \return 成功したステップ数
+        */
+        template <typename System>
+        std::size_t integrate_adaptive(System const & system, State & x, double t0, double t1, double dt);
+
+        //! A public member function (template function).
+        /*!
+            時刻t0からt1まで積分し、時間間隔dtごとにobserverを呼び出す
+            \param system 運動方程式
+            \param x 状態（積分結果で上書きされる）
+            \param t0 開始時刻
+            \param t1 終了時刻
+            \param dt 時間間隔（初期刻み幅を兼ねる）
+            \param observer 時間間隔dtごとに(x, t)を渡して呼び出される関数オブジェクト
+            \return 成功したステップ数
+        */
+        template <typename System, typename Observer>
+        std::size_t integrate_const(System const & system, State & x, double t0, double t1, double dt, Observer && observer);
+
+        //! A public member function (const).
+        /*!
+            直前の積分の最後に推定された刻み幅を返す
+            \return 直前の積分の最後に推定された刻み幅
+        */
+        double last_dt() const;
+
+        //! A public member function (const).
+        /*!
+            直前の積分で受理された各ステップの推定誤差（絶対誤差）の最大値を返す
+            \return 推定誤差の最大値
+        */
+        double max_error() const;
+
+        //! A public member function.
+        /*!
+            次数と刻み幅の推定値を初期状態に戻す
+        */
+        void reset();
+
+        //! A public member function.
+        /*!
+            許容誤差を変更する
+            \param eps_abs 許容絶対誤差
+            \param eps_rel 許容相対誤差
+        */
+        void seteps(double eps_abs, double eps_rel);
+
+        //! A public member function (template function).
+        /*!
+            1ステップの積分を試みる
+            \param system 運動方程式
+            \param x 状態（成功した場合のみ上書きされる）
+            \param t 時刻（成功した場合のみ進められる）
+            \param dt 刻み幅（次に試みるべき刻み幅で上書きされる）
+            \return 成功したかどうか
+        */
+        template <typename System>
+        bool try_step(System const & system, State & x, double & t, double & dt);
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+    private:
+        //! A private member function (template function).
+        /*!
+            時刻t0からt1まで、刻み幅を自動調整しながら積分する
+            \param system 運動方程式
+            \param x 状態（積分結果で上書きされる）
+            \param t0 開始時刻
+            \param t1 終了時刻
+            \param dt 初期刻み幅（最後に推定された刻み幅で上書きされる）
+            \return 成功したステップ数
+        */
+        template <typename System>
+        std::size_t adaptive(System const & system, State & x, double t0, double t1, double & dt);
+
+        //! A private member function.
+        /*!
+            多項式外挿によってdt→0の値を求める
+            \param k 段数
+            \param xest 外挿結果
+        */
+        void extrapolate(std::size_t k, State & xest);
+
+        //! A private member function (const).
+        /*!
+            与えられた誤差と段数に対する最適な刻み幅を求める
+            \param h 現在の刻み幅
+            \param error 誤差
+            \param k 段数
+            \return 最適な刻み幅
+        */
+        double calc_h_opt(double h, double error, std::size_t k) const;
+
+        //! A private member function (template function).
+        /*!
+            修正中点法でdtだけ積分する
+            \param system 運動方程式
+            \param in 積分前の状態
+            \param dxdt 積分前の状態の時間微分
+            \param t 時刻
+            \param out 積分後の状態
+            \param dt 刻み幅
+            \param steps 中間ステップの数
+        */
+        template <typename System>
+        void modified_midpoint(System const & system, State const & in, State const & dxdt, double t, State & out, double dt, std::size_t steps);
+
+        //! A private member function (const).
+        /*!
+            ステップを棄却すべきかどうかを判定する
+            \param error 誤差
+            \param k 段数
+            \return 棄却すべきかどうか
+        */
+        bool should_reject(double error, std::size_t k) const;
+
+        //! A private static member function.
+        /*!
+            状態xと同じ大きさ・同じアロケータの作業領域を構築する
+            \param x 状態
+            \return 作業領域
+        */
+        static State copystate(State const & x);
+
+        //! A private static member function (template function).
+        /*!
+            外挿に用いる各段数の積分結果の作業領域を、状態xと同じ大きさ・同じアロケータで構築する
+            \param x 状態
+            \return 作業領域
+        */
+        template <std::size_t... I>
+        static std::array<State, sizeof...(I)> filltable(State const & x, std::index_sequence<I...>);
+
+        //! A private static member function.
+        /*!
+            dt > 0のとき、t1 < t2かどうかを丸め誤差を考慮して判定する
+            \param t1 時刻1
+            \param t2 時刻2
+            \param dt 刻み幅
+            \return t1 < t2かどうか
+        */
+        static bool less_with_sign(double t1, double t2, double dt);
+
+        //! A private static member function.
+        /*!
+            dt > 0のとき、t1 <= t2かどうかを丸め誤差を考慮して判定する
+            \param t1 時刻1
+            \param t2 時刻2
+            \param dt 刻み幅
+            \return t1 <= t2かどうか
+        */
+        static bool less_eq_with_sign(double t1, double t2, double dt);
+
+        // #endregion privateメンバ関数
+
+        // #region メンバ変数
+
+        //! A private static member variable (constant expression).
+        /*!
+            最大の段数
+        */
+        static std::size_t constexpr K_MAX = 8;
+
+        //! A private static member variable (constant expression).
+        /*!
+            1回の積分で許される連続した棄却の最大回数
+        */
+        static auto constexpr MAX_FAILED_STEPS = 500;
+
+        //! A private static member variable (constant expression).
+        /*!
+            刻み幅制御の定数
+        */
+        static auto constexpr STEPFAC1 = 0.65;
+
+        //! A private static member variable (constant expression).
+        /*!
+            刻み幅制御の定数
+        */
+        static auto constexpr STEPFAC2 = 0.94;
+
+        //! A private static member variable (constant expression).
+        /*!
+            刻み幅制御の定数
+        */
+        static auto constexpr STEPFAC3 = 0.02;
+
+        //! A private static member variable (constant expression).
+        /*!
+            刻み幅制御の定数
+        */
+        static auto constexpr STEPFAC4 = 4.0;
+
+        //! A private static member variable (constant expression).
+        /*!
+            次数制御の定数
+        */
+        static auto constexpr KFAC2 = 0.9;
+
+        //! A private member variable.
+        /*!
+            外挿の係数
+        */
+        std::array<std::array<double, K_MAX + 1>, K_MAX + 1> coeff_;
+
+        //! A private member variable.
+        /*!
+            各段数の計算量
+        */
+        std::array<std::size_t, K_MAX + 1> cost_;
+
+        //! A private member variable.
+        /*!
+            現在の最適な段数の推定値
+        */
+        std::size_t current_k_opt_;
+
+        //! A private member variable.
+        /*!
+            前回のステップで推定した刻み幅
+        */
+        double dt_last_ = 0.0;
+
+        //! A private member variable.
+        /*!
+            積分前の状態の時間微分
+        */
+        State dxdt_;
+
+        //! A private member variable.
+        /*!
+            許容絶対誤差
+        */
+        double eps_abs_;
+
+        //! A private member variable.
+        /*!
+            許容相対誤差
+        */
+        double eps_rel_;
+
+        //! A private member variable.
+        /*!
+            誤差の推定値
+        */
+        State err_;
+
+        //! A private member variable.
+        /*!
+            各段数に対するfacminの値
+        */
+        std::array<double, K_MAX + 1> facmin_table_;
+
+        //! A private member variable.
+        /*!
+            最初のステップかどうか
+        */
+        bool first_;
+
+        //! A private member variable.
+        /*!
+            各段数の中間ステップの数
+        */
+        std::array<std::size_t, K_MAX + 1> interval_sequence_;
+
+        //! A private member variable.
+        /*!
+            前回のステップが棄却されたかどうか
+        */
+        bool last_step_rejected_;
+
+        //! A private member variable.
+        /*!
+            直前の積分で受理された各ステップの推定誤差（絶対誤差）の最大値
+        */
+        double max_error_ = 0.0;
+
+        //! A private member variable.
+        /*!
+            修正中点法の作業領域
+        */
+        State mp_dxdt_;
+
+        //! A private member variable.
+        /*!
+            修正中点法の作業領域
+        */
+        State mp_x0_;
+
+        //! A private member variable.
+        /*!
+            修正中点法の作業領域
+        */
+        State mp_x1_;
+
+        //! A private member variable.
+        /*!
+            外挿に用いる各段数の積分結果
+        */
+        std::array<State, K_MAX> table_;
+
+        //! A private member variable.
+        /*!
+            1ステップ積分した後の状態
+        */
+        State xnew_;
+
+        // #endregion メンバ変数
+    };
+
+    // #region コンストラクタ
+
+    template <typename State>
+    BulirschStoer<State>::BulirschStoer(double eps_abs, double eps_rel)
+        : BulirschStoer(eps_abs, eps_rel, State())
+    {
+    }
+
+    template <typename State>
+    BulirschStoer<State>::BulirschStoer(double eps_abs, double eps_rel, State const & x)
+        : dxdt_(copystate(x)),
+          eps_abs_(eps_abs),
+          eps_rel_(eps_rel),
+          err_(copystate(x)),
+          mp_dxdt_(copystate(x)),
+          mp_x0_(copystate(x)),
+          mp_x1_(copystate(x)),
+          table_(filltable(x, std::make_index_sequence<K_MAX>())),
+          xnew_(copystate(x))
+    {
+        for (auto i = 0U; i < K_MAX + 1; i++) {
+            interval_sequence_[i] = 2 * (i + 1);
+            cost_[i] = (i == 0) ? interval_sequence_[i] : cost_[i - 1] + interval_sequence_[i];
+            facmin_table_[i] = std::pow(BulirschStoer::STEPFAC3, 1.0 / static_cast<double>(2 * i + 1));
+
+            for (auto k = 0U; k < i; k++) {
+                auto const r = static_cast<double>(interval_sequence_[i]) / static_cast<double>(interval_sequence_[k]);
+
+                // 外挿の係数
+                coeff_[i][k] = 1.0 / (r * r - 1.0);
+            }
+        }
+
+        reset();
+    }
+
+    // #endregion コンストラクタ
+
+    // #region publicメンバ関数
+
+    template <typename State>
+    template <typename System>
+    std::size_t BulirschStoer<State>::integrate_adaptive(System const & system, State & x, double t0, double t1, double dt)
+    {
+        return adaptive(system, x, t0, t1, dt);
+    }
+
+    template <typename State>
+    template <typename System, typename Observer>
+    std::size_t BulirschStoer<State>::integrate_const(System const & system, State & x, double t0, double t1, double dt, Observer && observer)
+    {
+        auto time = t0;
+        auto const time_step = dt;
+        auto step = 0;
+        auto count = std::size_t(0);
+
+        while (less_eq_with_sign(time + time_step, t1, dt)) {
+            observer(x, time);
+
+            // 刻み幅の推定値は次の区間に引き継ぐ
+            count += adaptive(system, x, time, time + time_step, dt);
+
+            // time += dtとすると誤差が蓄積するので、毎回直接計算する
+            ++step;
+            time = t0 + static_cast<double>(step) * time_step;
+        }
+        observer(x, time);
+
+        return count;
+    }
+
+    template <typename State>
+    double BulirschStoer<State>::last_dt() const
+    {
+        return dt_last_;
+    }
+
+    template <typename State>
+    double BulirschStoer<State>::max_error() const
+    {
+        return max_error_;
+    }
+
+    template <typename State>
+    void BulirschStoer<State>::reset()
+    {
+        first_ = true;
+        last_step_rejected_ = false;
+        current_k_opt_ = 4;
+    }
+
+    template <typename State>
+    void BulirschStoer<State>::seteps(double eps_abs, double eps_rel)
+    {
+        eps_abs_ = eps_abs;
+        eps_rel_ = eps_rel;
+    }
+
+    template <typename State>
+    template <typename System>
+    bool BulirschStoer<State>::try_step(System const & system, State & x, double & t, double & dt)
+    {
+        system(x, dxdt_, t);
+
+        if (dt != dt_last_) {
+            // 外部から刻み幅が変更された
+            reset();
+        }
+
+        auto reject = true;
+
+        std::array<double, K_MAX + 1> h_opt = {};
+        std::array<double, K_MAX + 1> work = {};
+
+        auto new_h = dt;
+
+        // 推定誤差（絶対誤差）
+        auto abserror = 0.0;
+
+        for (auto k = std::size_t(0); k <= current_k_opt_ + 1; k++) {
+            if (k == 0) {
+                modified_midpoint(system, x, dxdt_, t, xnew_, dt, interval_sequence_[k]);
+                continue;
+            }
+
+            modified_midpoint(system, x, dxdt_, t, table_[k - 1], dt, interval_sequence_[k]);
+            extrapolate(k, xnew_);
+
+            // 誤差の推定値
+            auto error = 0.0;
+            abserror = 0.0;
+            for (auto i = 0U; i < x.size(); i++) {
+                err_[i] = xnew_[i] - table_[0][i];
+                abserror = std::max(abserror, std::fabs(err_[i]));
+                err_[i] = std::fabs(err_[i]) / (eps_abs_ + eps_rel_ * (std::fabs(x[i]) + std::fabs(dt) * std::fabs(dxdt_[i])));
+                error = std::max(error, std::fabs(err_[i]));
+            }
+
+            h_opt[k] = calc_h_opt(dt, error, k);
+            work[k] = static_cast<double>(cost_[k]) / h_opt[k];
+
+            if (k == current_k_opt_ - 1 || first_) {
+                // k_optより前で収束したか？
+                if (error < 1.0) {
+                    reject = false;
+                    if (work[k] < BulirschStoer::KFAC2 * work[k - 1] || current_k_opt_ <= 2) {
+                        // 次数はそのまま（最初のステップを除く）
+                        current_k_opt_ = std::min(static_cast<int>(K_MAX) - 1, std::max(2, static_cast<int>(k) + 1));
+                        new_h = h_opt[k];
+                        new_h *= static_cast<double>(cost_[k + 1]) / static_cast<double>(cost_[k]);
+                    }
+                    else {
+                        current_k_opt_ = std::min(static_cast<int>(K_MAX) - 1, std::max(2, static_cast<int>(k)));
+                        new_h = h_opt[k];
+                    }
+                    break;
+                }
+                else if (should_reject(error, k) && !first_) {
+                    reject = true;
+                    new_h = h_opt[k];
+                    break;
+                }
+            }
+
+            if (k == current_k_opt_) {
+                // k_optで収束したか？
+                if (error < 1.0) {
+                    reject = false;
+                    if (work[k - 1] < BulirschStoer::KFAC2 * work[k]) {
+                        current_k_opt_ = std::max(2, static_cast<int>(current_k_opt_) - 1);
+                        new_h = h_opt[current_k_opt_];
+                    }
+                    else if (work[k] < BulirschStoer::KFAC2 * work[k - 1] && !last_step_rejected_) {
+                        current_k_opt_ = std::min(static_cast<int>(K_MAX - 1), static_cast<int>(current_k_opt_) + 1);
+                        new_h = h_opt[k];
+                        new_h *= static_cast<double>(cost_[current_k_opt_]) / static_cast<double>(cost_[k]);
+                    }
+                    else {
+                        new_h = h_opt[current_k_opt_];
+                    }
+                    break;
+                }
+                else if (should_reject(error, k)) {
+                    reject = true;
+                    new_h = h_opt[current_k_opt_];
+                    break;
+                }
+            }
+
+            if (k == current_k_opt_ + 1) {
+                // k_opt + 1で収束したか？
+                if (error < 1.0) {
+                    reject = false;
+                    if (work[k - 2] < BulirschStoer::KFAC2 * work[k - 1]) {
+                        current_k_opt_ = std::max(2, static_cast<int>(current_k_opt_) - 1);
+                    }
+                    if (work[k] < BulirschStoer::KFAC2 * work[current_k_opt_] && !last_step_rejected_) {
+                        current_k_opt_ = std::min(static_cast<int>(K_MAX) - 1, static_cast<int>(k));
+                    }
+                    new_h = h_opt[current_k_opt_];
+                }
+                else {
+                    reject = true;
+                    new_h = h_opt[current_k_opt_];
+                }
+                break;
+            }
+        }
+
+        if (!reject) {
+            t += dt;
+            x = xnew_;
+            max_error_ = std::max(max_error_, abserror);
+        }
+
+        if (!last_step_rejected_ || less_with_sign(new_h, dt, dt)) {
+            dt_last_ = new_h;
+            dt = new_h;
+        }
+
+        last_step_rejected_ = reject;
+        first_ = false;
+
+        return !reject;
+    }
+
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    template <typename State>
+    template <typename System>
+    std::size_t BulirschStoer<State>::adaptive(System const & system, State & x, double t0, double t1, double & dt)
+    {
+        // boost::numeric::odeint::integrate_adaptiveはステッパーをコピーして使うため、
+        // 次数と刻み幅の推定値は呼び出しごとに初期状態から始まる（それに合わせる）
+        reset();
+        max_error_ = 0.0;
+
+        auto count = std::size_t(0);
+        while (less_with_sign(t0, t1, dt)) {
+            if (less_with_sign(t1, t0 + dt, dt)) {
+                dt = t1 - t0;
+            }
+
+            auto failed = 0;
+            while (!try_step(system, x, t0, dt)) {
+                if (failed++ >= BulirschStoer::MAX_FAILED_STEPS) {
+                    throw std::runtime_error("Max number of iterations exceeded. A new step size was not found.");
+                }
+            }
+
+            ++count;
+        }
+
+        return count;
+    }
+
+    template <typename State>
+    void BulirschStoer<State>::extrapolate(std::size_t k, State & xest)
+    {
+        for (auto j = static_cast<int>(k) - 1; j > 0; --j) {
+            for (auto i = 0U; i < xest.size(); i++) {
+                table_[j - 1][i] = (1.0 + coeff_[k][j]) * table_[j][i] + (-coeff_[k][j]) * table_[j - 1][i];
+            }
+        }
+
+        for (auto i = 0U; i < xest.size(); i++) {
+            xest[i] = (1.0 + coeff_[k][0]) * table_[0][i] + (-coeff_[k][0]) * xest[i];
+        }
+    }
+
+    template <typename State>
+    double BulirschStoer<State>::calc_h_opt(double h, double error, std::size_t k) const
+    {
+        auto const expo = 1.0 / static_cast<double>(2 * k + 1);
+        auto const facmin = facmin_table_[k];
+
+        double fac;
+        if (error == 0.0) {
+            fac = 1.0 / facmin;
+        }
+        else {
+            fac = BulirschStoer::STEPFAC2 / std::pow(error / BulirschStoer::STEPFAC1, expo);
+            fac = std::max(facmin / BulirschStoer::STEPFAC4, std::min(1.0 / facmin, fac));
+        }
+
+        return h * fac;
+    }
+
+    template <typename State>
+    template <typename System>
+    void BulirschStoer<State>::modified_midpoint(System const & system, State const & in, State const & dxdt, double t, State & out, double dt, std::size_t steps)
+    {
+        auto const h = dt / static_cast<double>(steps);
+        auto const h2 = 2.0 * h;
+
+        auto th = t + h;
+
+        // x1 = x + h * dxdt
+        for (auto i = 0U; i < in.size(); i++) {
+            mp_x1_[i] = 1.0 * in[i] + h * dxdt[i];
+        }
+
+        system(mp_x1_, mp_dxdt_, th);
+
+        mp_x0_ = in;
+
+        for (auto n = std::size_t(1); n != steps; n++) {
+            // tmp = x1; x1 = x0 + h2 * dxdt; x0 = tmp
+            for (auto i = 0U; i < in.size(); i++) {
+                auto const tmp = mp_x1_[i];
+                mp_x1_[i] = 1.0 * mp_x0_[i] + h2 * mp_dxdt_[i];
+                mp_x0_[i] = tmp;
+            }
+
+            th += h;
+            system(mp_x1_, mp_dxdt_, th);
+        }
+
+        // x = 0.5 * (x0 + x1 + h * dxdt)
+        for (auto i = 0U; i < in.size(); i++) {
+            out[i] = 0.5 * mp_x0_[i] + 0.5 * mp_x1_[i] + (0.5 * h) * mp_dxdt_[i];
+        }
+    }
+
+    template <typename State>
+    bool BulirschStoer<State>::should_reject(double error, std::size_t k) const
+    {
+        if (k == current_k_opt_ - 1) {
+            // Numerical Recipes 17.3.17の判定基準
+            double const d = static_cast<double>(interval_sequence_[current_k_opt_] * interval_sequence_[current_k_opt_ + 1] /
+                (interval_sequence_[0] * interval_sequence_[0]));
+            return error > d * d;
+        }
+        else if (k == current_k_opt_) {
+            double const d = static_cast<double>(interval_sequence_[current_k_opt_] / interval_sequence_[0]);
+            return error > d * d;
+        }
+        else {
+            return error > 1.0;
+        }
+    }
+
+    template <typename State>
+    State BulirschStoer<State>::copystate(State const & x)
+    {
+        if constexpr (has_allocator<State>::value) {
+            // std::pmr::vectorのコピーコンストラクタはアロケータを引き継がないので、明示的に渡す
+            return State(x, x.get_allocator());
+        }
+        else {
+            return x;
+        }
+    }
+
+    template <typename State>
+    template <std::size_t... I>
+    std::array<State, sizeof...(I)> BulirschStoer<State>::filltable(State const & x, std::index_sequence<I...>)
+    {
+        return { { (static_cast<void>(I), copystate(x))... } };
+    }
+
+    template <typename State>
+    bool BulirschStoer<State>::less_with_sign(double t1, double t2, double dt)
+    {
+        return dt > 0.0 ? t2 - t1 > std::numeric_limits<double>::epsilon() : t1 - t2 > std::numeric_limits<double>::epsilon();
+    }
+
+    template <typename State>
+    bool BulirschStoer<State>::less_eq_with_sign(double t1, double t2, double dt)
+    {
+        return dt > 0.0 ? t1 - t2 <= std::numeric_limits<double>::epsilon() : t2 - t1 <= std::numeric_limits<double>::epsilon();
+    }
+
+    // #endregion privateメンバ関数
+}
+
+#endif  // _BULIRSCHSTOER_H_
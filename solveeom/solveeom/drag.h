@@ -0,0 +1,108 @@
+﻿/*! \file drag.h
+    \brief 空気中を運動する球に働く抵抗を求める関数群の宣言と実装
+
+    Copyright © 2016-2018 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+#ifndef _DRAG_H_
+#define _DRAG_H_
+
+#pragma once
+
+#include <cmath>                                // for std::exp, std::pow
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+namespace solveeom {
+    //! A global variable (constant expression).
+    /*!
+        空気の粘度（kg/(m・s)）
+    */
+    static auto constexpr AIRMYU = 1.822E-5;
+
+    //! A global variable (constant expression).
+    /*!
+        空気の密度（kg/m^3）
+    */
+    static auto constexpr AIRRHO = 1.205;
+
+    //! A global variable (constant expression).
+    /*!
+        空気の動粘度
+    */
+    static auto constexpr AIRNYU = AIRMYU / AIRRHO;
+
+    //! A global variable (constant expression).
+    /*!
+        アルミニウムの密度（kg/m^3）
+    */
+    static auto constexpr ALUMINIUMRHO = 2698.9;
+
+    //! A global variable (constant expression).
+    /*!
+        レイノルズ数の閾値
+    */
+    static auto constexpr REYNOLDS_THRESHOLD = 0.1;
+
+    //! A function.
+    /*!
+        球の抵抗係数を求める
+        \param Re レイノルズ数
+        \return 抵抗係数
+    */
+    double dragcoefficient(double Re);
+
+    //! A function.
+    /*!
+        空気中を速さuで運動する球に働く抵抗の大きさを求める
+        \param r 球の半径
+        \param u 球の速さ（u >= 0）
+        \param isconsider_inertial_resistance 慣性抵抗を考慮するかどうか
+        \return 抵抗の大きさ（粘性抵抗 + 慣性抵抗）
+    */
+    double dragforce(double r, double u, bool isconsider_inertial_resistance);
+
+    // #region 関数の実装
+
+    inline double dragcoefficient(double Re)
+    {
+        // N.-S. Cheng, Comparison of formulas for drag coefficient and settling velocity of
+        // spherical particles, Powder Technology 189 (2009) 395–398.
+        if (Re <= 3000) {
+            return 24.0 / Re * std::pow(1.0 + 0.27 * Re, 0.43) + 0.47 * (1.0 - std::exp(-0.04 * std::pow(Re, 0.38)));
+        }
+
+        // Re > 3000
+        // Almedeij J. Drag coefficient of flow around a sphere: Matching asymptotically the wide
+        // trend. std::powder Technology. (2008);doi:10.1016/j.std::powtec.2007.12.006.
+        auto const phi1 = std::pow(24.0 / Re, 10) + std::pow(21.0 * std::pow(Re, -0.67), 10) +
+            std::pow(4.0 * std::pow(Re, -0.33), 10) + std::pow(0.4, 10);
+        auto const phi2 = 1.0 / (1.0 / std::pow(0.148 * std::pow(Re, 0.11), 10) + 1.0 / std::pow(0.5, 10));
+        auto const phi3 = std::pow((1.57E+8) * std::pow(Re, -1.625), 10);
+        auto const phi4 = 1.0 / (1.0 / std::pow((6.0E-17) * std::pow(Re, 2.63), 10) + 1.0 / std::pow(0.2, 10));
+
+        return std::pow((1.0 / (1.0 / (phi1 + phi2) + 1.0 / phi3) + phi4), 0.1);
+    }
+
+    inline double dragforce(double r, double u, bool isconsider_inertial_resistance)
+    {
+        // レイノルズ数
+        auto const Re = 2.0 * r * u / AIRNYU;
+
+        // 粘性抵抗
+        auto const F = 6.0 * boost::math::constants::pi<double>() * AIRMYU * r * u;
+
+        // レイノルズ数が閾値より小さいか、慣性抵抗を考慮しないなら
+        if (Re < REYNOLDS_THRESHOLD || !isconsider_inertial_resistance) {
+            // 粘性抵抗のみを考慮する
+            return F;
+        }
+
+        auto const FD = 0.5 * AIRRHO * boost::math::constants::pi<double>() * (r * u) * (r * u);
+
+        return FD * dragcoefficient(Re) + F;
+    }
+
+    // #endregion 関数の実装
+}
+
+#endif  // _DRAG_H_
@@ -0,0 +1,189 @@
+﻿/*! \file solvechaineom.cpp
+    \brief N個の振り子を連結した多重振り子に対して運動方程式を解くクラスの実装
+
+    Copyright © 2016-2018 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+#include "solvechaineom.h"
+#include "drag.h"
+#include <cmath>                                // for std::cos, std::sin, std::sqrt
+#include <boost/assert.hpp>                     // for BOOST_ASSERT
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+namespace solveeom {
+    // #region コンストラクタ・デストラクタ
+
+    SolveChainEoM::SolveChainEoM(std::int32_t n, float const * l, float const * r, float const * theta0, std::pmr::memory_resource * mr) :
+        Isconsider_Inertial_Resistance([this] { return isconsider_inertial_resistance_; }, [this](auto isconsider_inertial_resistance) { return isconsider_inertial_resistance_ = isconsider_inertial_resistance; }),
+        N([this] { return static_cast<std::int32_t>(n_); }, nullptr),
+        n_(static_cast<std::size_t>(n)),
+        l_(l, l + n, mr),
+        m_(n_, mr),
+        r_(r, r + n, mr),
+        cos_(n_, mr),
+        diag_(n_, mr),
+        fx_(n_, mr),
+        fy_(n_, mr),
+        offdiag_(n_, mr),
+        sin_(n_, mr),
+        tension_(n_, mr),
+        x_(2 * n_, 0.0, mr),
+        stepper_(SolveChainEoM::EPS, SolveChainEoM::EPS, x_)
+    {
+        BOOST_ASSERT(n > 0);
+
+        for (auto i = 0U; i < n_; i++) {
+            m_[i] = 4.0 / 3.0 * boost::math::constants::pi<double>() * r_[i] * r_[i] * r_[i] * ALUMINIUMRHO;
+            x_[i] = theta0[i];
+        }
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region publicメンバ関数
+
+    void SolveChainEoM::gettheta(float * theta) const
+    {
+        for (auto i = 0U; i < n_; i++) {
+            theta[i] = static_cast<float>(x_[i]);
+        }
+    }
+
+    void SolveChainEoM::getv(float * v) const
+    {
+        for (auto i = 0U; i < n_; i++) {
+            v[i] = static_cast<float>(l_[i] * x_[n_ + i]);
+        }
+    }
+
+    void SolveChainEoM::operator()(float dt)
+    {
+        stepper_.integrate_adaptive(
+            [this](auto const & x, auto & dxdt, double) { eom(x, dxdt); },
+            x_,
+            0.0,
+            static_cast<double>(dt),
+            SolveChainEoM::DX);
+    }
+
+    void SolveChainEoM::settheta(float const * theta)
+    {
+        for (auto i = 0U; i < n_; i++) {
+            x_[i] = theta[i];
+        }
+    }
+
+    void SolveChainEoM::setv(float const * v)
+    {
+        for (auto i = 0U; i < n_; i++) {
+            x_[n_ + i] = v[i] / l_[i];
+        }
+    }
+
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    void SolveChainEoM::dragforces(double const * omega) const
+    {
+        // 球の速度（上の球から順に、各ロープの回転による速度を足し合わせる）
+        auto vx = 0.0;
+        auto vy = 0.0;
+
+        for (auto k = 0U; k < n_; k++) {
+            vx += l_[k] * omega[k] * cos_[k];
+            vy += l_[k] * omega[k] * sin_[k];
+
+            auto const u = std::sqrt(vx * vx + vy * vy);
+            if (u > 0.0) {
+                // 抵抗は速度と逆向きに働く
+                auto const f = dragforce(r_[k], u, isconsider_inertial_resistance_) / u;
+                fx_[k] = -f * vx;
+                fy_[k] = -f * vy;
+            }
+            else {
+                fx_[k] = 0.0;
+                fy_[k] = 0.0;
+            }
+        }
+    }
+
+    void SolveChainEoM::eom(state_type const & x, state_type & dxdt) const
+    {
+        auto const theta = x.data();
+        auto const omega = x.data() + n_;
+
+        for (auto i = 0U; i < n_; i++) {
+            // dθ/dt = v / l
+            dxdt[i] = omega[i];
+
+            cos_[i] = std::cos(theta[i]);
+            sin_[i] = std::sin(theta[i]);
+        }
+
+        dragforces(omega);
+
+        // k番目のロープの向きをu[k] = (sinθ[k], -cosθ[k])、張力をT[k]とすると、k番目の球の加速度は
+        // a[k] = g + F[k] / m[k] + (-T[k]u[k] + T[k + 1]u[k + 1]) / m[k]
+        // ロープの長さが変わらないという拘束条件u[k]・(a[k] - a[k - 1]) = -l[k](dθ[k]/dt)²に代入すると、
+        // T[k - 1]、T[k]、T[k + 1]についての対称な三重対角の連立一次方程式になる
+        for (auto k = 0U; k < n_; k++) {
+            auto const invm = 1.0 / m_[k];
+
+            // 重力（上端の支点は動かないので、0番目のロープにのみ現れる）と空気抵抗
+            auto b = l_[k] * omega[k] * omega[k] + (sin_[k] * fx_[k] - cos_[k] * fy_[k]) * invm;
+            auto d = invm;
+
+            if (k == 0) {
+                b += SolveChainEoM::g * cos_[k];
+            }
+            else {
+                auto const invmprev = 1.0 / m_[k - 1];
+                b -= (sin_[k] * fx_[k - 1] - cos_[k] * fy_[k - 1]) * invmprev;
+                d += invmprev;
+            }
+
+            diag_[k] = d;
+            tension_[k] = b;
+
+            if (k + 1 < n_) {
+                // -u[k]・u[k + 1] / m[k] = -cos(θ[k] - θ[k + 1]) / m[k]
+                offdiag_[k] = -(cos_[k] * cos_[k + 1] + sin_[k] * sin_[k + 1]) * invm;
+            }
+        }
+
+        // 三重対角行列の前進消去
+        for (auto k = 1U; k < n_; k++) {
+            auto const w = offdiag_[k - 1] / diag_[k - 1];
+            diag_[k] -= w * offdiag_[k - 1];
+            tension_[k] -= w * tension_[k - 1];
+        }
+
+        // 後退代入
+        tension_[n_ - 1] /= diag_[n_ - 1];
+        for (auto k = static_cast<int>(n_) - 2; k >= 0; k--) {
+            tension_[k] = (tension_[k] - offdiag_[k] * tension_[k + 1]) / diag_[k];
+        }
+
+        // 各球の加速度を求め、ひとつ上の球に対する相対加速度の接線成分からd²θ/dt²を求める
+        auto axprev = 0.0;
+        auto ayprev = 0.0;
+
+        for (auto k = 0U; k < n_; k++) {
+            auto const tnext = k + 1 < n_ ? tension_[k + 1] : 0.0;
+            auto const snext = k + 1 < n_ ? sin_[k + 1] : 0.0;
+            auto const cnext = k + 1 < n_ ? cos_[k + 1] : 0.0;
+
+            auto const ax = (fx_[k] - tension_[k] * sin_[k] + tnext * snext) / m_[k];
+            auto const ay = -SolveChainEoM::g + (fy_[k] + tension_[k] * cos_[k] - tnext * cnext) / m_[k];
+
+            // d²θ/dt² = (cosθ[k], sinθ[k])・(a[k] - a[k - 1]) / l[k]
+            dxdt[n_ + k] = (cos_[k] * (ax - axprev) + sin_[k] * (ay - ayprev)) / l_[k];
+
+            axprev = ax;
+            ayprev = ay;
+        }
+    }
+
+    // #endregion privateメンバ関数
+}
@@ -0,0 +1,272 @@
+﻿/*! \file solvechaineom.h
+    \brief N個の振り子を連結した多重振り子に対して運動方程式を解くクラスの宣言
+
+    Copyright © 2016-2018 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+#ifndef _SOLVECHAINEOM_H_
+#define _SOLVECHAINEOM_H_
+
+#include "bulirschstoer.h"
+#include "utility/property.h"
+#include <cstddef>                      // for std::size_t
+#include <cstdint>                      // for std::int32_t
+#include <memory_resource>              // for std::pmr::memory_resource, std::pmr::get_default_resource
+#include <vector>                       // for std::pmr::vector
+
+namespace solveeom {
+    using namespace utility;
+
+    //! A class.
+    /*!
+        N個の振り子を連結した多重振り子（二重振り子を含む）に対して運動方程式を解くクラス
+        i番目の球はi - 1番目の球から長さl[i]の質量の無視できるロープで吊るされ、各球にそれぞれ空気抵抗が働く
+        角度θ[i]は鉛直下向きから測る。N = 1のときはSolveEoMと同じ運動方程式になる
+        （単振り子にはSolveEoMの方が速いので、そちらを用いること）
+        状態と作業領域は全て構築時に指定されたメモリリソースから確保され、積分中にはメモリを確保しない
+    */
+    class SolveChainEoM final {
+        //! A typedef.
+        /*!
+            状態（θ[0], ..., θ[N - 1], dθ[0]/dt, ..., dθ[N - 1]/dt）
+        */
+        using state_type = std::pmr::vector<double>;
+
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param n 振り子の数（n > 0でなければならない。呼び出し側で検査すること）
+            \param l 各ロープの長さ（要素数n）
+            \param r 各球の半径（要素数n）
+            \param theta0 各θの初期値（要素数n）
+            \param mr 状態と作業領域を確保するメモリリソース（呼び出し側のアリーナやプールを渡せる）
+        */
+        SolveChainEoM(std::int32_t n, float const * l, float const * r, float const * theta0,
+                      std::pmr::memory_resource * mr = std::pmr::get_default_resource());
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~SolveChainEoM() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        //! A public member function.
+        /*!
+            各角度θを配列に書き込む
+            \param theta 角度θの書き込み先（要素数N以上）
+        */
+        void gettheta(float * theta) const;
+
+        //! A public member function.
+        /*!
+            各球のひとつ上の球に対する相対的な速度v（= l[i]×dθ[i]/dt）を配列に書き込む
+            \param v 速度vの書き込み先（要素数N以上）
+        */
+        void getv(float * v) const;
+
+        //! A public member function.
+        /*!
+            運動方程式を、指定された時間まで積分する
+            \param dt 指定時間
+        */
+        void operator()(float dt);
+
+        //! A public member function.
+        /*!
+            各角度θを設定する
+            \param theta 設定する角度θ（要素数N以上）
+        */
+        void settheta(float const * theta);
+
+        //! A public member function.
+        /*!
+            各球のひとつ上の球に対する相対的な速度vを設定する
+            \param v 設定する速度v（要素数N以上）
+        */
+        void setv(float const * v);
+
+        // #endregion publicメンバ関数
+
+    private:
+        // #region privateメンバ関数
+
+        //! A private member function.
+        /*!
+            各球に働く空気抵抗を求め、fx_、fy_に書き込む（cos_、sin_は求めてあるものとする）
+            \param omega 各角速度dθ/dt（状態のうち後半N個の先頭）
+        */
+        void dragforces(double const * omega) const;
+
+        //! A private member function.
+        /*!
+            運動方程式
+            質量行列M(θ)は密行列で、そのまま解くとO(N^3)かかる。代わりに各ロープの張力を未知数とすると、
+            拘束条件は対称な三重対角の連立一次方程式になるので、これをO(N)で解いてから各d²θ/dt²を求める
+            \param x 現在の状態
+            \param dxdt 現在の状態の時間微分
+        */
+        void eom(state_type const & x, state_type & dxdt) const;
+
+        // #endregion privateメンバ関数
+
+        // #region プロパティ
+
+    public:
+        //! A property.
+        /*!
+            慣性抵抗を考慮するかどうかへのプロパティ
+        */
+        Property<bool> Isconsider_Inertial_Resistance;
+
+        //! A property.
+        /*!
+            振り子の数へのプロパティ
+        */
+        Property<std::int32_t> N;
+
+        // #endregion プロパティ
+
+        // #region メンバ変数
+
+    private:
+        //! A private static member variable (constant expression).
+        /*!
+            Bulirsch-Stoer法の初期刻み値
+        */
+        static auto constexpr DX = 0.01;
+
+        //! A private static member variable (constant expression).
+        /*!
+            許容誤差
+            多重振り子はカオス的に振る舞い、単振り子ほど厳しい許容誤差には意味がないので、実時間で解ける値にする
+        */
+        static auto constexpr EPS = 1.0E-10;
+
+        //! A private static member variable (constant expression).
+        /*!
+            重力加速度
+        */
+        static auto constexpr g = 9.80665;
+
+        //! A private member variable.
+        /*!
+            慣性抵抗を考慮するかどうか
+        */
+        bool isconsider_inertial_resistance_ = false;
+
+        //! A private member variable.
+        /*!
+            振り子の数
+        */
+        std::size_t const n_;
+
+        //! A private member variable.
+        /*!
+            各ロープの長さ
+        */
+        std::pmr::vector<double> l_;
+
+        //! A private member variable.
+        /*!
+            各球の質量
+        */
+        std::pmr::vector<double> m_;
+
+        //! A private member variable.
+        /*!
+            各球の半径
+        */
+        std::pmr::vector<double> r_;
+
+        //! A private member variable.
+        /*!
+            作業領域（各cosθ）
+        */
+        mutable std::pmr::vector<double> cos_;
+
+        //! A private member variable.
+        /*!
+            作業領域（張力の連立一次方程式の対角成分）
+        */
+        mutable std::pmr::vector<double> diag_;
+
+        //! A private member variable.
+        /*!
+            作業領域（各球に働く空気抵抗のx成分）
+        */
+        mutable std::pmr::vector<double> fx_;
+
+        //! A private member variable.
+        /*!
+            作業領域（各球に働く空気抵抗のy成分）
+        */
+        mutable std::pmr::vector<double> fy_;
+
+        //! A private member variable.
+        /*!
+            作業領域（張力の連立一次方程式の非対角成分）
+        */
+        mutable std::pmr::vector<double> offdiag_;
+
+        //! A private member variable.
+        /*!
+            作業領域（各sinθ）
+        */
+        mutable std::pmr::vector<double> sin_;
+
+        //! A private member variable.
+        /*!
+            作業領域（張力の連立一次方程式の右辺と、その解である各ロープの張力）
+        */
+        mutable std::pmr::vector<double> tension_;
+
+        //! A private member variable.
+        /*!
+            微分方程式の現在の状態
+        */
+        state_type x_;
+
+        //! A private member variable.
+        /*!
+            Bulirsch-Stoer法のオブジェクト
+            作業領域は構築時に状態と同じ大きさで、状態と同じメモリリソースから確保され、積分中にメモリを確保しない
+        */
+        BulirschStoer<state_type> stepper_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        SolveChainEoM() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        SolveChainEoM(SolveChainEoM const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        SolveChainEoM & operator=(SolveChainEoM const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _SOLVECHAINEOM_H_
@@ -5,10 +5,15 @@
     This software is released under the BSD 2-Clause License.
 */
 #include "solveeom.h"
-#include <cmath>                                // for std::sin, std::cos
-#include <fstream>                              // for std::ofstream
+#include <algorithm>                            // for std::for_each, std::max, std::min
+#include <chrono>                               // for std::chrono
+#include <cmath>                                // for std::sin, std::cos, std::floor
+#include <execution>                            // for std::execution::par_unseq
+#include <fstream>                              // for std::ifstream, std::ofstream
+#include <type_traits>                          // for std::is_trivially_copyable_v
 #include <boost/assert.hpp>                     // for BOOST_ASSERT
 #include <boost/format.hpp>                     // for boost::format
+#include <boost/iterator/counting_iterator.hpp> // for boost::counting_iterator
 #include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
 #include "solveeommain.h"
 
@@ -16,17 +21,64 @@ namespace solveeom {
     // #region コンストラクタ・デストラクタ
 
     SolveEoM::SolveEoM(float l, float r, float theta0) :
+		Budget([this] { return budget_; }, [this](auto budget) {
+			// 時間予算モードを始めるとき・やめるときは、元の許容誤差と初期刻み値に戻す
+			budget_ = budget;
+			dx_ = SolveEoM::DX;
+			eps_ = SolveEoM::EPS;
+			elapsed_ = 0.0;
+			elapsed_average_ = 0.0;
+			stepper_.seteps(SolveEoM::EPS, SolveEoM::EPS);
+			energy_stepper_.seteps(SolveEoM::EPS, SolveEoM::EPS);
+			return budget_;
+		}),
 		Isconsider_Inertial_Resistance(nullptr, [this](auto isconsider_inertial_resistance) { return isconsider_inertial_resistance_ = isconsider_inertial_resistance; }),
-        Theta([this] { return static_cast<float>(x_[0]); }, [this](auto theta) { return x_[0] = theta; }),
+		Isconsider_Energy_Budget([this] { return isconsider_energy_budget_; }, [this](auto isconsider_energy_budget) {
+			if (isconsider_energy_budget && !isconsider_energy_budget_) {
+				energybudgetreset();
+			}
+			return isconsider_energy_budget_ = isconsider_energy_budget;
+		}),
+		Isconsider_Rotation([this] { return isconsider_rotation_; }, [this](auto isconsider_rotation) {
+			if (isconsider_rotation) {
+				wrapangle();
+			}
+			else {
+				// 回転数を角度θに戻す
+				x_[0] += 2.0 * boost::math::constants::pi<double>() * static_cast<double>(winding_);
+				winding_ = 0;
+			}
+			return isconsider_rotation_ = isconsider_rotation;
+		}),
+        Theta([this] { return static_cast<float>(x_[0]); }, [this](auto theta) {
+			x_[0] = theta;
+			if (isconsider_rotation_) {
+				winding_ = 0;
+				wrapangle();
+			}
+			// 外から与えたエネルギーを積分誤差として数えないよう、エネルギー収支の基準を取り直す
+			if (isconsider_energy_budget_) {
+				energybudgetreset();
+			}
+			return theta;
+		}),
 		Theta0(nullptr, [this](auto theta0) { return theta0_ = theta0; }),
 		Time([this] { return static_cast<float>(t_); }, [this](auto t) { return t_ = t; }),
-		V([this] { return static_cast<float>(l_ * x_[1]); }, [this](auto v) { return x_[1] = v / l_; }),
+		V([this] { return static_cast<float>(l_ * x_[1]); }, [this](auto v) {
+			x_[1] = v / l_;
+			if (isconsider_energy_budget_) {
+				energybudgetreset();
+			}
+			return v;
+		}),
+		Winding([this] { return winding_; }, nullptr),
         l_(l),
 		omega0_2_(g / l_),
         r_(r),
-		m_(4.0 / 3.0 * boost::math::constants::pi<double>() * r * r * r * SolveEoM::ALUMINIUMRHO),
+		m_(4.0 / 3.0 * boost::math::constants::pi<double>() * r * r * r * ALUMINIUMRHO),
 		gamma_(3.0 * boost::math::constants::pi<double>() * r_ * AIRMYU / m_),
 		stepper_(SolveEoM::EPS, SolveEoM::EPS),
+		energy_stepper_(SolveEoM::EPS, SolveEoM::EPS),
 		t_(0.0),
 		theta0_(theta0),
 		x_({ theta0, 0.0 })
@@ -37,23 +89,69 @@ namespace solveeom {
 
     // #region publicメンバ関数
 
-	float SolveEoM::gettheta_fumofumobun_approx() const
+	SolveEoM::Accuracy SolveEoM::accuracy() const
 	{
-		return static_cast<float>(theta0_ * std::exp(-gamma_ * t_) *
-								  std::cos(std::sqrt((omega0_2_ - gamma_ * gamma_) * (3.0 + std::cos(theta0_ * std::exp(-gamma_ * t_)))) / 2.0 * t_));
+		Accuracy ac;
+		ac.budget = budget_;
+		ac.elapsed = elapsed_;
+		ac.eps = budget_ > 0.0 ? eps_ : SolveEoM::EPS;
+		ac.dx = budget_ > 0.0 ? dx_ : SolveEoM::DX;
+		ac.error = error_;
+
+		return ac;
 	}
 
-	float SolveEoM::getv_fumofumobun_approx() const
-    {
-		auto const term1 = -gamma_ * gettheta_fumofumobun_approx();
+	SolveEoM::Checkpoint SolveEoM::checkpoint() const
+	{
+		Checkpoint cp = {};
+		cp.magic = SolveEoM::CHECKPOINT_MAGIC;
+		cp.version = SolveEoM::CHECKPOINT_VERSION;
+		cp.isconsider_inertial_resistance = isconsider_inertial_resistance_ ? 1 : 0;
+		cp.isconsider_energy_budget = isconsider_energy_budget_ ? 1 : 0;
+		cp.isconsider_rotation = isconsider_rotation_ ? 1 : 0;
+		cp.winding = winding_;
+		cp.l = l_;
+		cp.r = r_;
+		cp.t = t_;
+		cp.theta0 = theta0_;
+		cp.dissipated = dissipated_;
+		cp.energy0 = energy0_;
+		cp.budget = budget_;
+		cp.eps = eps_;
+		cp.dx = dx_;
+		cp.elapsed_average = elapsed_average_;
+		cp.x = x_;
 
-		auto const alpha = 0.5 * std::sqrt((omega0_2_ - gamma_ * gamma_) * (3.0 + std::cos(theta0_ * std::exp(-gamma_ * t_))));
+		return cp;
+	}
 
-		auto const term2 = -alpha * theta0_* std::exp(-gamma_ * t_) * std::sin(alpha * t_) *
-						   (0.5 * theta0_ * gamma_ * std::exp(-gamma_ * t_) * std::sin(theta0_ * std::exp(-gamma_ * t_)) /
-						   (3.0 + std::cos(theta0_ * std::exp(-gamma_ * t_))) * t_ + 1.0);
+	SolveEoM::EnergyBudget SolveEoM::energybudget() const
+	{
+		EnergyBudget eb;
+		eb.kinetic = 0.5 * m_ * sqr(l_ * x_[1]);
+		eb.potential = m_ * SolveEoM::g * l_ * (1.0 - std::cos(x_[0]));
+		eb.dissipated = dissipated_;
+		eb.drift = eb.kinetic + eb.potential + eb.dissipated - energy0_;
 
-		return l_ * (term1 + term2);
+		return eb;
+	}
+
+	void SolveEoM::energybudgetreset()
+	{
+		auto const eb = energybudget();
+
+		dissipated_ = 0.0;
+		energy0_ = eb.kinetic + eb.potential;
+	}
+
+	float SolveEoM::gettheta_fumofumobun_approx() const
+	{
+		return static_cast<float>(theta_fumofumobun_approx(t_));
+	}
+
+	float SolveEoM::getv_fumofumobun_approx() const
+    {
+		return static_cast<float>(v_fumofumobun_approx(t_));
     }
 
 	float SolveEoM::kinetic_energy(double v) const
@@ -63,31 +161,66 @@ namespace solveeom {
 
     float SolveEoM::operator()(float dt)
     {
-        boost::numeric::odeint::integrate_adaptive(
-            stepper_,
-            getEoM(),
-            x_,
-            0.0,
-            static_cast<double>(dt),
-            SolveEoM::DX);
+        if (budget_ <= 0.0) {
+            return step(dt, SolveEoM::DX);
+        }
 
-        return static_cast<float>(x_[0]);
+        auto const start = std::chrono::steady_clock::now();
+        auto const theta = step(dt, dx_);
+        auto const end = std::chrono::steady_clock::now();
+
+        tunebudget(std::chrono::duration<double, std::micro>(end - start).count());
+
+        return theta;
     }
 	
     void SolveEoM::operator()(double dt, std::string const & filename, double t)
     {
         std::ofstream result(filename);
 
-        boost::numeric::odeint::integrate_const(
-            stepper_,
-            getEoM(),
+        if (isconsider_energy_budget_) {
+            // 時刻、θ、近似関数によるθに続けて、エネルギー収支（運動、ポテンシャル、散逸、ずれ）を出力する
+            energy_state_type y = { x_[0], x_[1], dissipated_ };
+            energy_stepper_.integrate_const(
+                [this](auto const & x, auto & dxdt, double) { eomwithdissipation(x, dxdt); },
+                y,
+                0.0,
+                t,
+                dt,
+                [&result, this](auto & y, auto const t)
+                {
+                    x_ = { y[0], y[1] };
+                    dissipated_ = y[2];
+
+                    if (isconsider_rotation_) {
+                        wrapangle();
+                        y[0] = x_[0];
+                    }
+
+                    auto const eb = energybudget();
+                    result << boost::format("%.3f, %.15f, %.15f, %.15f, %.15f, %.15f, %.15e")
+                        % t % y[0] % gettheta_fumofumobun_approx() % eb.kinetic % eb.potential % eb.dissipated % eb.drift;
+                    writewinding(result);
+                });
+
+            return;
+        }
+
+        stepper_.integrate_const(
+            [this](auto const & x, auto & dxdt, double) { eom(x, dxdt); },
             x_,
             0.0,
             t,
             dt,
-            [&result, this](auto const & x, auto const t)
+            [&result, this](auto & x, auto const t)
             {
-				result << boost::format("%.3f, %.15f, %.15f\n") % t % x[0] % gettheta_fumofumobun_approx();
+                // xはx_そのものなので、折り返しはそのまま次の区間の積分に引き継がれる
+                if (isconsider_rotation_) {
+                    wrapangle();
+                }
+
+				result << boost::format("%.3f, %.15f, %.15f") % t % x[0] % gettheta_fumofumobun_approx();
+                writewinding(result);
             });
     }
 
@@ -96,6 +229,86 @@ namespace solveeom {
 		return static_cast<float>(m_ * SolveEoM::g * l_ * (1.0 - std::cos(theta)));
 	}
 
+	void SolveEoM::restore(Checkpoint const & cp)
+	{
+		BOOST_ASSERT(cp.l == l_ && cp.r == r_);
+
+		isconsider_energy_budget_ = cp.isconsider_energy_budget != 0;
+		isconsider_inertial_resistance_ = cp.isconsider_inertial_resistance != 0;
+		isconsider_rotation_ = cp.isconsider_rotation != 0;
+		winding_ = cp.winding;
+		dissipated_ = cp.dissipated;
+		energy0_ = cp.energy0;
+		t_ = cp.t;
+		theta0_ = cp.theta0;
+		x_ = cp.x;
+
+		// 時間予算モードは、調整済みの許容誤差と初期刻み値ごと引き継ぐ
+		budget_ = cp.budget;
+		eps_ = cp.eps;
+		dx_ = cp.dx;
+		elapsed_ = 0.0;
+		elapsed_average_ = cp.elapsed_average;
+		stepper_.seteps(eps_, eps_);
+		energy_stepper_.seteps(eps_, eps_);
+	}
+
+	bool SolveEoM::savecheckpoint(std::string const & filename) const
+	{
+		static_assert(std::is_trivially_copyable_v<Checkpoint>, "Checkpoint must be trivially copyable");
+
+		auto const cp = checkpoint();
+
+		std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+		ofs.write(reinterpret_cast<char const *>(&cp), sizeof(Checkpoint));
+
+		return static_cast<bool>(ofs);
+	}
+
+	void SolveEoM::tabulate(float * theta, float * v, std::int32_t n, float dt)
+	{
+		// 時間発展は逐次的にしか求められないので、状態のコピーを1ステップずつ進める
+		// 時間予算モードでは、次のnextstepと同じく調整済みの許容誤差と初期刻み値で積分する（ただし途中で調整はしない）
+		auto const dx = budget_ > 0.0 ? dx_ : SolveEoM::DX;
+		auto x = x_;
+		for (auto i = 0; i < n; i++) {
+			stepper_.integrate_adaptive(
+				[this](auto const & x, auto & dxdt, double) { eom(x, dxdt); },
+				x,
+				0.0,
+				static_cast<double>(dt),
+				dx);
+
+			if (isconsider_rotation_) {
+				wrap(x[0]);
+			}
+
+			theta[i] = static_cast<float>(x[0]);
+			if (v) {
+				v[i] = static_cast<float>(l_ * x[1]);
+			}
+		}
+	}
+
+	void SolveEoM::tabulate_fumofumobun_approx(float * theta, float * v, std::int32_t n, double t0, double dt) const
+	{
+		// 各時刻の値は互いに独立なので並列に求める
+		// （libstdc++では並列アルゴリズムの実装にTBBを用いるので、g++でビルドするときは-ltbbが必要）
+		std::for_each(
+			std::execution::par_unseq,
+			boost::counting_iterator<std::int32_t>(0),
+			boost::counting_iterator<std::int32_t>(n),
+			[theta, v, t0, dt, this](auto i)
+			{
+				auto const t = t0 + static_cast<double>(i) * dt;
+
+				theta[i] = static_cast<float>(theta_fumofumobun_approx(t));
+				if (v) {
+					v[i] = static_cast<float>(v_fumofumobun_approx(t));
+				}
+			});
+	}
+
 	void SolveEoM::timereset()
     {
 		t_ = 0.0;
@@ -103,62 +316,212 @@ namespace solveeom {
 
     // #endregion publicメンバ関数
 
+    // #region publicstaticメンバ関数
+
+	std::optional<SolveEoM::Checkpoint> SolveEoM::loadcheckpoint(std::string const & filename)
+	{
+		std::ifstream ifs(filename, std::ios::binary);
+
+		Checkpoint cp;
+		if (!ifs.read(reinterpret_cast<char *>(&cp), sizeof(Checkpoint))) {
+			return std::nullopt;
+		}
+
+		if (!isvalid(cp)) {
+			return std::nullopt;
+		}
+
+		return cp;
+	}
+
+	bool SolveEoM::isvalid(Checkpoint const & cp)
+	{
+		return cp.magic == SolveEoM::CHECKPOINT_MAGIC && cp.version == SolveEoM::CHECKPOINT_VERSION;
+	}
+
+    // #endregion publicstaticメンバ関数
+
     // #region privateメンバ関数
 
-	std::function<void(SolveEoM::state_type const &, SolveEoM::state_type &, double const)> SolveEoM::getEoM() const
+	std::pair<double, double> SolveEoM::dragacceleration(double omega) const
+	{
+		// レイノルズ数
+		auto const Re = 2.0 * r_ * std::fabs(l_ * omega) / AIRNYU;
+
+		// 粘性抵抗
+		auto const F = 6.0 * boost::math::constants::pi<double>() * AIRMYU * r_ * l_ * omega;
+
+		// レイノルズ数が閾値より小さいか、「慣性抵抗も考慮」チェックボックスが外れていたら
+		if (Re < REYNOLDS_THRESHOLD || !isconsider_inertial_resistance_) {
+			// 粘性抵抗のみを考慮する
+			return { 0.0, F / (m_ * l_) };
+		}
+
+		auto const FD = 0.5 * AIRRHO * boost::math::constants::pi<double>() * sqr(r_ * (l_ * omega));
+
+		// Drag coefficient
+		auto const CD = dragcoefficient(Re);
+
+		// 慣性抵抗÷(m×l)
+		auto const f2 = (omega >= 0.0) ? -FD * CD / (m_ * l_) : FD * CD / (m_ * l_);
+		return { f2, F / (m_ * l_) };
+	}
+
+	void SolveEoM::eom(state_type const & x, state_type & dxdt) const
+	{
+		// dθ/dt = v / l
+		dxdt[0] = x[1];
+
+		// 振り子に働く力
+		auto const f1 = -SolveEoM::g * std::sin(x[0]) / l_;
+
+		auto const [f2, f3] = dragacceleration(x[1]);
+		dxdt[1] = f1 + f2 - f3;
+	}
+
+	void SolveEoM::eomwithdissipation(energy_state_type const & x, energy_state_type & dxdt) const
+	{
+		// dθ/dt = v / l
+		dxdt[0] = x[1];
+
+		// 振り子に働く力
+		auto const f1 = -SolveEoM::g * std::sin(x[0]) / l_;
+
+		auto const [f2, f3] = dragacceleration(x[1]);
+		dxdt[1] = f1 + f2 - f3;
+
+		// 抵抗による仕事率 -(m×l×(f2 - f3))×(l×dθ/dt)
+		dxdt[2] = -m_ * l_ * l_ * (f2 - f3) * x[1];
+	}
+
+    float SolveEoM::step(float dt, double dx)
     {
-        auto const eom = [this](state_type const & x, state_type & dxdt, double const)
-        {
-            // dθ/dt = v / l
-            dxdt[0] = x[1];
+        if (isconsider_energy_budget_) {
+            // 散逸エネルギーをθ、dθ/dtと同時に積分する
+            energy_state_type y = { x_[0], x_[1], dissipated_ };
+            energy_stepper_.integrate_adaptive(
+                [this](auto const & x, auto & dxdt, double) { eomwithdissipation(x, dxdt); },
+                y,
+                0.0,
+                static_cast<double>(dt),
+                dx);
 
-            // 振り子に働く力
-            auto const f1 = -SolveEoM::g * std::sin(x[0]) / l_;
+            x_ = { y[0], y[1] };
+            dissipated_ = y[2];
+            error_ = energy_stepper_.max_error();
 
-			// レイノルズ数
-			auto const Re = 2.0 * r_ * std::fabs(l_ * x[1]) / AIRNYU;
+            if (isconsider_rotation_) {
+                wrapangle();
+            }
 
-            // 粘性抵抗
-            auto const F = 6.0 * boost::math::constants::pi<double>() * AIRMYU * r_ * l_ * x[1];
+            return static_cast<float>(x_[0]);
+        }
 
-			// レイノルズ数が閾値より小さいか、「慣性抵抗も考慮」チェックボックスが外れていたら
-			if (Re < SolveEoM::REYNOLDS_THRESHOLD || !isconsider_inertial_resistance_) {
-				// 粘性抵抗のみを考慮する
-				dxdt[1] = f1 - F / (m_ * l_);
+        // 次数と刻み幅の推定値は呼び出しごとに初期化されるので、積分結果はx_のみで決まる
+        stepper_.integrate_adaptive(
+            [this](auto const & x, auto & dxdt, double) { eom(x, dxdt); },
+            x_,
+            0.0,
+            static_cast<double>(dt),
+            dx);
 
-				return;
-			}
+        error_ = stepper_.max_error();
 
-			auto const FD = 0.5 * AIRRHO * boost::math::constants::pi<double>() * sqr(r_ * (l_ * x[1]));
+        if (isconsider_rotation_) {
+            // θを有界に保ち、相対誤差の許容値がθとともに緩むのを防ぐ
+            wrapangle();
+        }
 
-			// Drag coefficient
-			double CD;
+        return static_cast<float>(x_[0]);
+    }
 
-			// N.-S. Cheng, Comparison of formulas for drag coefficient and settling velocity of
-			// spherical particles, Powder Technology 189 (2009) 395–398.
-			if (Re <= 3000) {
-				CD = 24.0 / Re * std::pow(1.0 + 0.27 * Re, 0.43) + 0.47 * (1.0 - std::exp(-0.04 * std::pow(Re, 0.38)));
-			}
-			else {
-				// Re > 3000
-				// Almedeij J. Drag coefficient of flow around a sphere: Matching asymptotically the wide
-				// trend. std::powder Technology. (2008);doi:10.1016/j.std::powtec.2007.12.006.
-				auto const phi1 = std::pow(24.0 / Re, 10) + std::pow(21.0 * std::pow(Re, -0.67), 10) +
-					std::pow(4.0 * std::pow(Re, -0.33), 10) + std::pow(0.4, 10);
-				auto const phi2 = 1.0 / (1.0 / std::pow(0.148 * std::pow(Re, 0.11), 10) + 1.0 / std::pow(0.5, 10));
-				auto const phi3 = std::pow((1.57E+8) * std::pow(Re, -1.625), 10);
-				auto const phi4 = 1.0 / (1.0 / std::pow((6.0E-17) * std::pow(Re, 2.63), 10) + 1.0 / std::pow(0.2, 10));
-
-				CD = std::pow((1.0 / (1.0 / (phi1 + phi2) + 1.0 / phi3) + phi4), 0.1);
+	double SolveEoM::theta_fumofumobun_approx(double t) const
+	{
+		return theta0_ * std::exp(-gamma_ * t) *
+			   std::cos(std::sqrt((omega0_2_ - gamma_ * gamma_) * (3.0 + std::cos(theta0_ * std::exp(-gamma_ * t)))) / 2.0 * t);
+	}
+
+	void SolveEoM::tunebudget(double elapsed)
+	{
+		elapsed_ = elapsed;
+		elapsed_average_ = elapsed_average_ > 0.0 ?
+			(1.0 - SolveEoM::ELAPSED_WEIGHT) * elapsed_average_ + SolveEoM::ELAPSED_WEIGHT * elapsed : elapsed;
+
+		if (elapsed > budget_) {
+			// 時間予算を超えたら、次の呼び出しからすぐに許容誤差を緩める
+			// ただし推定誤差がすでに上限の近くまで大きくなっていれば、緩めても精度を失うだけなので緩めない
+			if (error_ < SolveEoM::ERROR_HEADROOM * SolveEoM::EPS_MAX) {
+				eps_ = std::min(SolveEoM::EPS_MAX, eps_ * SolveEoM::EPS_LOOSEN);
 			}
+		}
+		else if (elapsed_average_ < SolveEoM::BUDGET_HEADROOM * budget_ || error_ > SolveEoM::EPS_MAX) {
+			// 平均して時間予算に余裕があるか、推定誤差が上限を超えていれば、許容誤差を少しずつ元の値に戻す
+			eps_ = std::max(SolveEoM::EPS, eps_ * SolveEoM::EPS_TIGHTEN);
+		}
 
-			// 慣性抵抗÷(m×l)
-			auto const f2 = (x[1] >= 0.0) ? -FD * CD / (m_ * l_) : FD * CD / (m_ * l_);
-			dxdt[1] = f1 + f2 - F / (m_ * l_);
-        };
+		stepper_.seteps(eps_, eps_);
+		energy_stepper_.seteps(eps_, eps_);
 
-        return eom;
-    }
+		// 次の呼び出しは、直前の呼び出しの最後に推定された刻み幅から始める
+		auto const dtlast = isconsider_energy_budget_ ? energy_stepper_.last_dt() : stepper_.last_dt();
+		if (dtlast > 0.0) {
+			dx_ = dtlast;
+		}
+	}
+
+	double SolveEoM::v_fumofumobun_approx(double t) const
+	{
+		auto const term1 = -gamma_ * theta_fumofumobun_approx(t);
+
+		auto const alpha = 0.5 * std::sqrt((omega0_2_ - gamma_ * gamma_) * (3.0 + std::cos(theta0_ * std::exp(-gamma_ * t))));
+
+		auto const term2 = -alpha * theta0_* std::exp(-gamma_ * t) * std::sin(alpha * t) *
+						   (0.5 * theta0_ * gamma_ * std::exp(-gamma_ * t) * std::sin(theta0_ * std::exp(-gamma_ * t)) /
+						   (3.0 + std::cos(theta0_ * std::exp(-gamma_ * t))) * t + 1.0);
+
+		return l_ * (term1 + term2);
+	}
+
+	void SolveEoM::wrapangle()
+	{
+		winding_ += wrap(x_[0]);
+	}
+
+	void SolveEoM::writewinding(std::ofstream & result) const
+	{
+		// 回転モードでは最後の列に回転数を出力する
+		if (isconsider_rotation_) {
+			result << ", " << winding_;
+		}
+
+		result << '\n';
+	}
 
     // #endregion privateメンバ関数
+
+    // #region privatestaticメンバ関数
+
+	std::int64_t SolveEoM::wrap(double & theta)
+	{
+		auto const pi = boost::math::constants::pi<double>();
+		auto const twopi = boost::math::constants::two_pi<double>();
+
+		auto const n = std::floor((theta + pi) / twopi);
+		theta -= twopi * n;
+		auto winding = static_cast<std::int64_t>(n);
+
+		// 丸め誤差で区間の端からはみ出した場合の補正
+		if (theta >= pi) {
+			theta -= twopi;
+			++winding;
+		}
+		else if (theta < -pi) {
+			theta += twopi;
+			--winding;
+		}
+
+		return winding;
+	}
+
+    // #endregion privatestaticメンバ関数
 }
@@ -7,12 +7,15 @@
 #ifndef _SOLVEEOM_H_
 #define _SOLVEEOM_H_
 
+#include "bulirschstoer.h"
+#include "drag.h"
 #include "utility/property.h"
 #include <array>                        // for std::array
-#include <cstdint>						// for std::int32_t
-#include <functional>                   // for std::function
+#include <cstdint>						// for std::int32_t, std::int64_t, std::uint32_t
+#include <fstream>                      // for std::ofstream
+#include <optional>                     // for std::optional
 #include <string>                       // for std::string
-#include <boost/numeric/odeint.hpp>     // for boost::numeric::odeint
+#include <utility>                      // for std::pair
 
 namespace solveeom {
     using namespace utility;
@@ -51,6 +54,197 @@ namespace solveeom {
         */
         using state_type = std::array<double, 2>;
 
+        //! A typedef.
+        /*!
+            散逸エネルギーを追加した拡大状態（θ、dθ/dt、散逸エネルギー）
+        */
+        using energy_state_type = std::array<double, 3>;
+
+    public:
+        //! A struct.
+        /*!
+            ソルバーの全状態を保持するチェックポイント
+            ファイルにはこの構造体をそのままバイナリで書き出す
+        */
+        struct Checkpoint final {
+            //! A public member variable.
+            /*!
+                マジックナンバー
+            */
+            std::uint32_t magic;
+
+            //! A public member variable.
+            /*!
+                フォーマットのバージョン
+            */
+            std::uint32_t version;
+
+            //! A public member variable.
+            /*!
+                慣性抵抗を考慮するかどうか
+            */
+            std::int32_t isconsider_inertial_resistance;
+
+            //! A public member variable.
+            /*!
+                エネルギー収支を追跡するかどうか
+            */
+            std::int32_t isconsider_energy_budget;
+
+            //! A public member variable.
+            /*!
+                回転モードかどうか
+            */
+            std::int32_t isconsider_rotation;
+
+            //! A public member variable.
+            /*!
+                予約領域（アライメント用）
+            */
+            std::uint32_t reserved;
+
+            //! A public member variable.
+            /*!
+                回転数
+            */
+            std::int64_t winding;
+
+            //! A public member variable.
+            /*!
+                棒の端から球までの長さ
+            */
+            double l;
+
+            //! A public member variable.
+            /*!
+                球の半径
+            */
+            double r;
+
+            //! A public member variable.
+            /*!
+                経過時間
+            */
+            double t;
+
+            //! A public member variable.
+            /*!
+                角度θの初期値θ₀
+            */
+            double theta0;
+
+            //! A public member variable.
+            /*!
+                抵抗によって散逸したエネルギー
+            */
+            double dissipated;
+
+            //! A public member variable.
+            /*!
+                エネルギー収支の追跡を開始した時点の全エネルギー
+            */
+            double energy0;
+
+            //! A public member variable.
+            /*!
+                1回の呼び出しあたりの時間予算（μs、0なら時間予算モードではない）
+            */
+            double budget;
+
+            //! A public member variable.
+            /*!
+                時間予算モードで次の呼び出しに用いる許容誤差
+            */
+            double eps;
+
+            //! A public member variable.
+            /*!
+                時間予算モードで次の呼び出しに用いる初期刻み値
+            */
+            double dx;
+
+            //! A public member variable.
+            /*!
+                時間予算モードでの計算時間の指数移動平均（μs）
+            */
+            double elapsed_average;
+
+            //! A public member variable.
+            /*!
+                微分方程式の現在の状態
+            */
+            state_type x;
+        };
+
+        //! A struct.
+        /*!
+            エネルギー収支
+            P/Invokeの呼び出し1回で全ての値を取得できるよう、doubleのみで構成する
+        */
+        struct EnergyBudget final {
+            //! A public member variable.
+            /*!
+                運動エネルギー
+            */
+            double kinetic;
+
+            //! A public member variable.
+            /*!
+                ポテンシャルエネルギー
+            */
+            double potential;
+
+            //! A public member variable.
+            /*!
+                抵抗によって散逸したエネルギー
+            */
+            double dissipated;
+
+            //! A public member variable.
+            /*!
+                エネルギーのずれ（運動エネルギー + ポテンシャルエネルギー + 散逸エネルギー - 初期の全エネルギー）
+                ThetaやVで状態を変えると基準が取り直されるので、積分誤差のみを表す
+            */
+            double drift;
+        };
+
+        //! A struct.
+        /*!
+            時間予算モードでの精度と計算時間
+            P/Invokeの呼び出し1回で全ての値を取得できるよう、doubleのみで構成する
+        */
+        struct Accuracy final {
+            //! A public member variable.
+            /*!
+                1回の呼び出しあたりの時間予算（μs、0なら時間予算モードではない）
+            */
+            double budget;
+
+            //! A public member variable.
+            /*!
+                直前の呼び出しに要した時間（μs）
+            */
+            double elapsed;
+
+            //! A public member variable.
+            /*!
+                次の呼び出しで用いる許容誤差
+            */
+            double eps;
+
+            //! A public member variable.
+            /*!
+                次の呼び出しで用いるBulirsch-Stoer法の初期刻み値
+            */
+            double dx;
+
+            //! A public member variable.
+            /*!
+                直前の呼び出しで受理された各ステップの推定誤差（絶対誤差）の最大値
+            */
+            double error;
+        };
+
         // #region コンストラクタ・デストラクタ
         
     public:
@@ -73,6 +267,33 @@ namespace solveeom {
 
         // #region publicメンバ関数
         
+		//! A public member function.
+		/*!
+			時間予算モードでの精度と計算時間を返す
+			\return 直前の呼び出しの精度と計算時間
+		*/
+		Accuracy accuracy() const;
+
+		//! A public member function.
+		/*!
+			現在の状態をチェックポイントとして返す
+			\return 現在の状態のチェックポイント
+		*/
+		Checkpoint checkpoint() const;
+
+		//! A public member function.
+		/*!
+			現在のエネルギー収支を求める
+			\return 現在のエネルギー収支
+		*/
+		EnergyBudget energybudget() const;
+
+		//! A public member function.
+		/*!
+			散逸エネルギーを0に戻し、現在の全エネルギーをエネルギー収支の基準にする
+		*/
+		void energybudgetreset();
+
 		//! A public member function.
 		/*!
 			@fumofumobunさんの近似関数によって、角度θを求める
@@ -98,6 +319,7 @@ namespace solveeom {
         //! A public member function.
         /*!
             運動方程式を、指定された時間まで積分する
+            時間予算モードでは、計算に要した時間と推定誤差から次の呼び出しの許容誤差と初期刻み値を調整する
             \param dt 指定時間
             \return 積分結果
         */
@@ -111,6 +333,46 @@ namespace solveeom {
 		*/
 		float potential_energy(double theta) const;
 
+		//! A public member function.
+		/*!
+			チェックポイントから状態を復元する
+			cp.lとcp.rはこのオブジェクトのものと一致していなければならない
+			\param cp 復元するチェックポイント
+		*/
+		void restore(Checkpoint const & cp);
+
+		//! A public member function.
+		/*!
+			現在の状態をチェックポイントファイルに保存する
+			\param filename 保存ファイル名
+			\return 保存に成功したかどうか
+		*/
+		bool savecheckpoint(std::string const & filename) const;
+
+		//! A public member function.
+		/*!
+			現在の状態から時間間隔dtごとにn個の角度θと速度vを求め、配列に書き込む
+			時間予算モードでなければ、各要素はnextstep(dt)を繰り返し呼んだ結果と一致する。現在の状態は変更しない
+			時間予算モードでは、nextstepが呼び出しごとに計算時間から許容誤差と初期刻み値を調整し直すので一致しない
+			（その時点の許容誤差と初期刻み値のまま求めるので、精度は次のnextstepと同程度になる）
+			\param theta 角度θの書き込み先（要素数n以上）
+			\param v 速度vの書き込み先（要素数n以上、nullptrなら書き込まない）
+			\param n 要素数
+			\param dt 時間間隔
+		*/
+		void tabulate(float * theta, float * v, std::int32_t n, float dt);
+
+		//! A public member function.
+		/*!
+			@fumofumobunさんの近似関数によって、時刻t0から時間間隔dtごとにn個の角度θと速度vを求め、配列に並列に書き込む
+			\param theta 角度θの書き込み先（要素数n以上）
+			\param v 速度vの書き込み先（要素数n以上、nullptrなら書き込まない）
+			\param n 要素数
+			\param t0 最初の要素の時刻
+			\param dt 時間間隔
+		*/
+		void tabulate_fumofumobun_approx(float * theta, float * v, std::int32_t n, double t0, double dt) const;
+
         //! A public member function.
         /*!
             運動方程式を、指定された時間まで積分し、その結果を時間間隔dtごとにファイルに保存する
@@ -128,30 +390,145 @@ namespace solveeom {
 
         // #endregion publicメンバ関数
 
+        // #region publicstaticメンバ関数
+
+		//! A public static member function.
+		/*!
+			チェックポイントファイルを読み込む
+			\param filename 読み込むファイル名
+			\return 読み込んだチェックポイント（失敗した場合はstd::nullopt）
+		*/
+		static std::optional<Checkpoint> loadcheckpoint(std::string const & filename);
+
+		//! A public static member function.
+		/*!
+			チェックポイントのマジックナンバーとバージョンが正しいかどうかを返す
+			\param cp チェックポイント
+			\return 正しいかどうか（バージョンが異なればレイアウトも異なるのでfalse）
+		*/
+		static bool isvalid(Checkpoint const & cp);
+
+        // #endregion publicstaticメンバ関数
+
     private:
         // #region privateメンバ関数
 
         //! A private member function.
         /*!
-            運動方程式を返す
-            \return 運動方程式のstd::function
+            慣性抵抗と粘性抵抗による角加速度を求める
+            運動方程式で元の加算順序（振り子に働く力 + 慣性抵抗 - 粘性抵抗）を保つため、二つを別々に返す
+            \param omega 角速度dθ/dt
+            \return 慣性抵抗による角加速度と、粘性抵抗による角加速度の大きさ（符号はomegaと同じ）の組
+        */
+        std::pair<double, double> dragacceleration(double omega) const;
+
+        //! A private member function.
+        /*!
+            運動方程式
+            \param x 現在の状態
+            \param dxdt 現在の状態の時間微分
+        */
+        void eom(state_type const & x, state_type & dxdt) const;
+
+        //! A private member function.
+        /*!
+            散逸エネルギーを追加した運動方程式
+            \param x 現在の状態
+            \param dxdt 現在の状態の時間微分
         */
-        std::function<void(state_type const &, state_type &, double const)> getEoM() const;
-		
+        void eomwithdissipation(energy_state_type const & x, energy_state_type & dxdt) const;
+
+        //! A private member function.
+        /*!
+            運動方程式を、指定された時間まで積分する
+            \param dt 指定時間
+            \param dx Bulirsch-Stoer法の初期刻み値
+            \return 積分結果
+        */
+        float step(float dt, double dx);
+
+        //! A private member function.
+        /*!
+            @fumofumobunさんの近似関数によって、時刻tでの角度θを求める
+            \param t 時刻
+            \return 時刻tでの角度θ
+        */
+        double theta_fumofumobun_approx(double t) const;
+
+        //! A private member function.
+        /*!
+            時間予算モードで、直前の呼び出しに要した時間から次の呼び出しの許容誤差と初期刻み値を調整する
+            \param elapsed 直前の呼び出しに要した時間（μs）
+        */
+        void tunebudget(double elapsed);
+
+        //! A private member function.
+        /*!
+            @fumofumobunさんの近似関数によって、時刻tでの速度vを求める
+            \param t 時刻
+            \return 時刻tでの速度v
+        */
+        double v_fumofumobun_approx(double t) const;
+
+        //! A private member function.
+        /*!
+            角度θを[-π, π)に折り返し、その分を回転数に加える
+        */
+        void wrapangle();
+
+        //! A private member function.
+        /*!
+            回転モードであれば回転数の列を出力し、行を終える
+            \param result 出力先のファイルストリーム
+        */
+        void writewinding(std::ofstream & result) const;
+
         // #endregion privateメンバ関数
 
+        // #region privatestaticメンバ関数
+
+        //! A private static member function.
+        /*!
+            角度θを[-π, π)に折り返す
+            \param theta 角度θ（折り返した値で上書きされる）
+            \return 折り返した回転数
+        */
+        static std::int64_t wrap(double & theta);
+
+        // #endregion privatestaticメンバ関数
+
         // #region プロパティ
 
     public:
+		//! A property.
+		/*!
+			1回の呼び出しあたりの時間予算（μs）へのプロパティ
+			0より大きい値を設定すると時間予算モードになり、0を設定すると元の許容誤差と初期刻み値に戻る
+		*/
+		Property<double> Budget;
+
 		//! A property.
 		/*!
 			慣性抵抗を考慮するかどうかへのプロパティ
 		*/
 		Property<float> Isconsider_Inertial_Resistance;
 
+		//! A property.
+		/*!
+			エネルギー収支を追跡するかどうかへのプロパティ
+		*/
+		Property<bool> Isconsider_Energy_Budget;
+
+		//! A property.
+		/*!
+			回転モードかどうかへのプロパティ
+			回転モードでは、角度θを[-π, π)に折り返し、回転数を別に数える
+		*/
+		Property<bool> Isconsider_Rotation;
+
         //! A property.
         /*!
-            角度θへのプロパティ
+            角度θへのプロパティ（エネルギー収支を追跡していれば、設定時にその基準を取り直す）
         */
         Property<float> Theta;
 
@@ -169,38 +546,38 @@ namespace solveeom {
 
         //! A property.
         /*!
-            速度vへのプロパティ
+            速度vへのプロパティ（エネルギー収支を追跡していれば、設定時にその基準を取り直す）
         */
         Property<float> V;
 
+		//! A property.
+		/*!
+			回転数（回転モードでのみ変化する）へのプロパティ
+		*/
+		Property<std::int64_t> Winding;
+
         // #endregion プロパティ
 
         // #region メンバ変数
 
     private:
-        //! A private static member variable (constant expression).
-        /*!
-            空気の粘度（kg/(m・s)）
-        */
-        static auto constexpr AIRMYU = 1.822E-5;
+		//! A private static member variable (constant expression).
+		/*!
+			時間予算モードで、平均の計算時間が時間予算のこの割合を下回ったら許容誤差を締める
+		*/
+		static auto constexpr BUDGET_HEADROOM = 0.5;
 
-        //! A private static member variable (constant expression).
-        /*!
-            空気の密度（kg/m^3）
-        */
-        static auto constexpr AIRRHO = 1.205;
+		//! A private static member variable (constant expression).
+		/*!
+			チェックポイントファイルのマジックナンバー（"SEOM"）
+		*/
+		static std::uint32_t constexpr CHECKPOINT_MAGIC = 0x4D4F4553;
 
 		//! A private static member variable (constant expression).
 		/*!
-			空気の動粘度
+			チェックポイントファイルのバージョン
 		*/
-		static auto constexpr AIRNYU = SolveEoM::AIRMYU / SolveEoM::AIRRHO;
-		
-        //! A private static member variable (constant expression).
-        /*!
-            アルミニウムの密度（kg/m^3）
-        */
-        static auto constexpr ALUMINIUMRHO = 2698.9;
+		static std::uint32_t constexpr CHECKPOINT_VERSION = 4;
 
         //! A private static member variable (constant expression).
         /*!
@@ -208,30 +585,114 @@ namespace solveeom {
         */
         static auto constexpr DX = 0.01;
 
+		//! A private static member variable (constant expression).
+		/*!
+			時間予算モードで、計算時間の指数移動平均をとるときの重み
+		*/
+		static auto constexpr ELAPSED_WEIGHT = 0.25;
+
         //! A private static member variable (constant expression).
         /*!
             許容誤差
         */
         static auto constexpr EPS = 1.0E-14;
 
+		//! A private static member variable (constant expression).
+		/*!
+			時間予算モードで許容誤差を緩めるときの倍率（超過にはすぐに対応する）
+		*/
+		static auto constexpr EPS_LOOSEN = 10.0;
+
+		//! A private static member variable (constant expression).
+		/*!
+			時間予算モードでの許容誤差の上限
+		*/
+		static auto constexpr EPS_MAX = 1.0E-6;
+
+		//! A private static member variable (constant expression).
+		/*!
+			時間予算モードで許容誤差を締めるときの倍率（振動しないよう、緩めるときよりゆっくり戻す）
+		*/
+		static auto constexpr EPS_TIGHTEN = 0.5;
+
+		//! A private static member variable (constant expression).
+		/*!
+			時間予算モードで、推定誤差が許容誤差の上限のこの割合を超えていたら、時間予算を超えても許容誤差を緩めない
+		*/
+		static auto constexpr ERROR_HEADROOM = 0.1;
+
         //! A private static member variable (constant expression).
         /*!
             重力加速度
         */
         static auto constexpr g = 9.80665;
 
-		//! A private static member variable (constant expression).
+		//! A private member variable.
+		/*!
+			1回の呼び出しあたりの時間予算（μs、0なら時間予算モードではない）
+		*/
+		double budget_ = 0.0;
+
+		//! A private member variable.
+		/*!
+			抵抗によって散逸したエネルギー
+		*/
+		double dissipated_ = 0.0;
+
+		//! A private member variable.
+		/*!
+			時間予算モードでのBulirsch-Stoer法の初期刻み値
+		*/
+		double dx_ = SolveEoM::DX;
+
+		//! A private member variable.
+		/*!
+			時間予算モードで、直前の呼び出しに要した時間（μs）
+		*/
+		double elapsed_ = 0.0;
+
+		//! A private member variable.
+		/*!
+			時間予算モードで、呼び出しに要した時間の指数移動平均（μs）
+		*/
+		double elapsed_average_ = 0.0;
+
+		//! A private member variable.
 		/*!
-			レイノルズ数の閾値
+			エネルギー収支の追跡を開始した時点の全エネルギー
 		*/
-		static auto constexpr REYNOLDS_THRESHOLD = 0.1;
+		double energy0_ = 0.0;
 
 		//! A private member variable.
 		/*!
-			棒の端から球までの長さ
+			時間予算モードでの許容誤差
+		*/
+		double eps_ = SolveEoM::EPS;
+
+		//! A private member variable.
+		/*!
+			直前の呼び出しで受理された各ステップの推定誤差（絶対誤差）の最大値
+		*/
+		double error_ = 0.0;
+
+		//! A private member variable.
+		/*!
+			エネルギー収支を追跡するかどうか
+		*/
+		bool isconsider_energy_budget_ = false;
+
+		//! A private member variable.
+		/*!
+			慣性抵抗を考慮するかどうか
 		*/
 		bool isconsider_inertial_resistance_ = false;
 
+		//! A private member variable.
+		/*!
+			回転モードかどうか
+		*/
+		bool isconsider_rotation_ = false;
+
         //! A private member variable.
         /*!
             棒の端から球までの長さ
@@ -264,9 +725,16 @@ namespace solveeom {
 
 		//! A private member variable.
         /*!
-            Bulirsch-Stoer法のBoost.ODEIntオブジェクト
+            Bulirsch-Stoer法のオブジェクト
+            作業領域はこのオブジェクト自身に含まれ、積分中にヒープ領域を確保しない
         */
-        boost::numeric::odeint::bulirsch_stoer<state_type> stepper_;
+        BulirschStoer<state_type> stepper_;
+
+		//! A private member variable.
+		/*!
+			散逸エネルギーを追加した拡大状態に対するBulirsch-Stoer法のオブジェクト
+		*/
+		BulirschStoer<energy_state_type> energy_stepper_;
         
 		//! A private member variable.
 		/*!
@@ -286,6 +754,12 @@ namespace solveeom {
         */
         state_type x_;
 
+		//! A private member variable.
+		/*!
+			回転数（角度θ = x_[0] + 2π×winding_）
+		*/
+		std::int64_t winding_ = 0;
+
         // #endregion メンバ変数
 
         // #region 禁止されたコンストラクタ・メンバ関数
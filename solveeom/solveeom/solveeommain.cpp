@@ -5,13 +5,44 @@
     This software is released under the BSD 2-Clause License.
 */
 #include "solveeommain.h"
+#include <array>     // for std::array
+#include <cstdint>   // for std::uint8_t
+#include <new>       // for std::bad_alloc
 
 extern "C" {
+	void __stdcall energybudgetreset()
+	{
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::ENERGYBUDGETRESET);
+		}
+
+		pse->energybudgetreset();
+	}
+
+	void __stdcall getaccuracy(solveeom::SolveEoM::Accuracy * ac)
+	{
+		*ac = pse->accuracy();
+	}
+
+	void __stdcall getenergybudget(solveeom::SolveEoM::EnergyBudget * eb)
+	{
+		*eb = pse->energybudget();
+	}
+
     float __stdcall gettheta()
     {
         return pse->Theta();
     }
 
+	void __stdcall getthetachain(float * theta)
+	{
+		if (!psce) {
+			return;
+		}
+
+		psce->gettheta(theta);
+	}
+
 	float __stdcall gettheta_fumofumobun_approx()
 	{
 		return pse->gettheta_fumofumobun_approx();
@@ -27,11 +58,73 @@ extern "C" {
         return pse->V();
     }
 
+	void __stdcall getvchain(float * v)
+	{
+		if (!psce) {
+			return;
+		}
+
+		psce->getv(v);
+	}
+
+	std::int64_t __stdcall getwinding()
+	{
+		return pse->Winding();
+	}
+
     void __stdcall init(float l, float r, float theta0)
     {
+        if (ptrace) {
+            ptrace->write(solveeom::TraceOpcode::INIT, std::array<float, 3>{ l, r, theta0 });
+        }
+
         pse.emplace(l, r, theta0);
     }
 
+	bool __stdcall initchain(std::int32_t n, float const * l, float const * r, float const * theta0)
+	{
+		// SolveChainEoMはn > 0を前提に構築されるので、ここで不正な引数を弾く
+		if (n <= 0 || !l || !r || !theta0) {
+			return false;
+		}
+
+		for (auto i = 0; i < n; i++) {
+			if (!(l[i] > 0.0f) || !(r[i] > 0.0f)) {
+				return false;
+			}
+		}
+
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::INITCHAIN, n);
+			ptrace->writearray(l, n);
+			ptrace->writearray(r, n);
+			ptrace->writearray(theta0, n);
+		}
+
+		try {
+			psce.emplace(n, l, r, theta0);
+		}
+		catch (std::bad_alloc const &) {
+			// 例外をC言語のインターフェースの外に投げないようにする
+			// SolveChainEoMはムーブできず、emplaceは構築の前に古いオブジェクトを破棄するので、ここでpsceは空になる
+			return false;
+		}
+
+		return true;
+	}
+
+	bool __stdcall loadcheckpoint(char const * filename)
+	{
+		auto const cp = solveeom::SolveEoM::loadcheckpoint(filename);
+		if (!cp) {
+			return false;
+		}
+
+		restore(&*cp);
+
+		return true;
+	}
+
 	float __stdcall kinetic_energy(double v)
 	{
 		return pse->kinetic_energy(v);
@@ -39,46 +132,206 @@ extern "C" {
 
     float __stdcall nextstep(float dt)
     {
+        if (ptrace) {
+            ptrace->write(solveeom::TraceOpcode::NEXTSTEP, dt);
+        }
+
         return (*pse)(dt);
     }
 
+	void __stdcall nextstepchain(float dt)
+	{
+		if (!psce) {
+			return;
+		}
+
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::NEXTSTEPCHAIN, dt);
+		}
+
+		(*psce)(dt);
+	}
+
 	float __stdcall potential_energy(double theta)
 	{
 		return pse->potential_energy(theta);
 	}
 
+	void __stdcall restore(solveeom::SolveEoM::Checkpoint const * cp)
+	{
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::RESTORE, *cp);
+		}
+
+		pse.emplace(static_cast<float>(cp->l), static_cast<float>(cp->r), static_cast<float>(cp->theta0));
+		pse->restore(*cp);
+	}
+
     void __stdcall saveresult(double dt, std::string const & filename, double t)
     {
+		// 積分して状態を進めるので、再生で同じ状態になるよう記録する
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::SAVERESULT, std::array<double, 2>{ dt, t });
+		}
+
         (*pse)(dt, filename, t);
     }
 
+	bool __stdcall savecheckpoint(char const * filename)
+	{
+		return pse->savecheckpoint(filename);
+	}
+
+	void __stdcall setbudget(double budget)
+	{
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::SETBUDGET, budget);
+		}
+
+		pse->Budget = budget;
+	}
+
+	void __stdcall setisconsider_energy_budget(bool isconsider_energy_budget)
+	{
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::SETISCONSIDER_ENERGY_BUDGET, static_cast<std::uint8_t>(isconsider_energy_budget));
+		}
+
+		pse->Isconsider_Energy_Budget = isconsider_energy_budget;
+	}
+
+	void __stdcall setisconsider_rotation(bool isconsider_rotation)
+	{
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::SETISCONSIDER_ROTATION, static_cast<std::uint8_t>(isconsider_rotation));
+		}
+
+		pse->Isconsider_Rotation = isconsider_rotation;
+	}
+
 	void __stdcall setisconsider_inertial_resistance(bool isconsider_inertial_resistance)
     {
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::SETISCONSIDER_INERTIAL_RESISTANCE, static_cast<std::uint8_t>(isconsider_inertial_resistance));
+		}
+
 		pse->Isconsider_Inertial_Resistance = isconsider_inertial_resistance;
     }
 
+	void __stdcall setisconsider_inertial_resistancechain(bool isconsider_inertial_resistance)
+	{
+		if (!psce) {
+			return;
+		}
+
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::SETISCONSIDER_INERTIAL_RESISTANCECHAIN, static_cast<std::uint8_t>(isconsider_inertial_resistance));
+		}
+
+		psce->Isconsider_Inertial_Resistance = isconsider_inertial_resistance;
+	}
+
     void __stdcall settheta(float theta)
     {
+        if (ptrace) {
+            ptrace->write(solveeom::TraceOpcode::SETTHETA, theta);
+        }
+
         pse->Theta = theta;
     }
 
+	void __stdcall setthetachain(float const * theta)
+	{
+		if (!psce) {
+			return;
+		}
+
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::SETTHETACHAIN, psce->N());
+			ptrace->writearray(theta, psce->N());
+		}
+
+		psce->settheta(theta);
+	}
+
 	void __stdcall settheta0(float theta0)
 	{
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::SETTHETA0, theta0);
+		}
+
 		pse->Theta0 = theta0;
 	}
 
 	void __stdcall settime(float dt)
     {
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::SETTIME, dt);
+		}
+
 		pse->Time = pse->Time() + dt;
     }
 
     void __stdcall setv(float v)
     {
+        if (ptrace) {
+            ptrace->write(solveeom::TraceOpcode::SETV, v);
+        }
+
         pse->V = v;
     }
 
+	void __stdcall setvchain(float const * v)
+	{
+		if (!psce) {
+			return;
+		}
+
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::SETVCHAIN, psce->N());
+			ptrace->writearray(v, psce->N());
+		}
+
+		psce->setv(v);
+	}
+
+	bool __stdcall starttrace(char const * filename)
+	{
+		ptrace.emplace(filename);
+		if (!ptrace->good()) {
+			ptrace.reset();
+			return false;
+		}
+
+		// 記録を途中から始めても再生できるよう、現在の状態を記録しておく
+		if (pse) {
+			ptrace->write(solveeom::TraceOpcode::RESTORE, pse->checkpoint());
+		}
+
+		return true;
+	}
+
+	void __stdcall stoptrace()
+	{
+		ptrace.reset();
+	}
+
+	void __stdcall tabulate(float * theta, float * v, std::int32_t n, float dt)
+	{
+		pse->tabulate(theta, v, n, dt);
+	}
+
+	void __stdcall tabulate_fumofumobun_approx(float * theta, float * v, std::int32_t n, float t0, float dt)
+	{
+		pse->tabulate_fumofumobun_approx(theta, v, n, static_cast<double>(t0), static_cast<double>(dt));
+	}
+
 	void __stdcall timereset()
 	{
+		if (ptrace) {
+			ptrace->write(solveeom::TraceOpcode::TIMERESET);
+		}
+
 		pse->timereset();
 	}
 }
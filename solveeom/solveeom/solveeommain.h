@@ -13,7 +13,9 @@
 #define DLLEXPORT __declspec(dllexport)
 #endif
 
+#include "solvechaineom.h"
 #include "solveeom.h"
+#include "trace.h"
 #include <optional>		// for std::optional
 
 extern "C" {
@@ -22,13 +24,53 @@ extern "C" {
         SolveEOMクラスのオブジェクトへのポインタ
     */
     static std::optional<solveeom::SolveEoM> pse;
+
+    //! A global variable.
+    /*!
+        SolveChainEoMクラスのオブジェクトへのポインタ
+        （initchainの前や、initchainが構築中に失敗した後は空で、多重振り子の関数は何もしない）
+    */
+    static std::optional<solveeom::SolveChainEoM> psce;
+
+    //! A global variable.
+    /*!
+        トレースを記録するオブジェクトへのポインタ（記録していなければ空）
+    */
+    static std::optional<solveeom::TraceWriter> ptrace;
     
+	//! A global function.
+	/*!
+		散逸エネルギーを0に戻し、現在の全エネルギーをエネルギー収支の基準にする
+	*/
+	DLLEXPORT void __stdcall energybudgetreset();
+
+	//! A global function.
+	/*!
+		時間予算モードでの精度と計算時間を求める
+		\param ac 精度と計算時間の格納先
+	*/
+	DLLEXPORT void __stdcall getaccuracy(solveeom::SolveEoM::Accuracy * ac);
+
+	//! A global function.
+	/*!
+		現在のエネルギー収支を求める
+		\param eb エネルギー収支の格納先
+	*/
+	DLLEXPORT void __stdcall getenergybudget(solveeom::SolveEoM::EnergyBudget * eb);
+
     //! A global function.
     /*!
         角度θの値に対するgetter
         \return 角度θ
     */
     DLLEXPORT float __stdcall gettheta();
+
+	//! A global function.
+	/*!
+		多重振り子の各角度θを配列に書き込む
+		\param theta 角度θの書き込み先（要素数は振り子の数以上）
+	*/
+	DLLEXPORT void __stdcall getthetachain(float * theta);
     
 	//! A global function.
 	/*!
@@ -51,6 +93,20 @@ extern "C" {
     */
     DLLEXPORT float __stdcall getv();
 
+	//! A global function.
+	/*!
+		多重振り子の各球のひとつ上の球に対する相対的な速度vを配列に書き込む
+		\param v 速度vの書き込み先（要素数は振り子の数以上）
+	*/
+	DLLEXPORT void __stdcall getvchain(float * v);
+
+	//! A global function.
+	/*!
+		回転数の値に対するgetter
+		\return 回転数（角度θ = gettheta() + 2π×回転数）
+	*/
+	DLLEXPORT std::int64_t __stdcall getwinding();
+
     //! A global function.
     /*!
         seオブジェクトを初期化する
@@ -60,6 +116,28 @@ extern "C" {
     */
     DLLEXPORT void __stdcall init(float l, float r, float theta0);
 
+	//! A global function.
+	/*!
+		sceオブジェクト（多重振り子）を初期化する
+		引数が不正なとき（nが0以下、配列がnullptr、長さか半径が0以下）は何もせずにfalseを返す
+		構築中にメモリを確保できなかったときもfalseを返すが、それまでの多重振り子は破棄されている
+		\param n 振り子の数
+		\param l 各ロープの長さ（要素数n）
+		\param r 各球の半径（要素数n）
+		\param theta0 各θの初期値（要素数n）
+		\return 初期化に成功したかどうか
+	*/
+	DLLEXPORT bool __stdcall initchain(std::int32_t n, float const * l, float const * r, float const * theta0);
+
+	//! A global function.
+	/*!
+		チェックポイントファイルから状態を復元する
+		seオブジェクトはチェックポイントに保存されたl、r、θ₀で初期化し直される
+		\param filename 読み込むファイル名
+		\return 復元に成功したかどうか
+	*/
+	DLLEXPORT bool __stdcall loadcheckpoint(char const * filename);
+
 	//! A global function.
 	/*!
 		運動エネルギーを求める
@@ -76,6 +154,13 @@ extern "C" {
     */
     DLLEXPORT float __stdcall nextstep(float dt);
 
+	//! A global function.
+	/*!
+		多重振り子の次のステップを計算する
+		\param dt 前ステップからの経過時間
+	*/
+	DLLEXPORT void __stdcall nextstepchain(float dt);
+
 	//! A global function.
 	/*!
 		ポテンシャルエネルギーを求める
@@ -93,6 +178,44 @@ extern "C" {
     */
     DLLEXPORT void __stdcall saveresult(double dt, std::string const & filename, double t);
 
+	//! A global function.
+	/*!
+		チェックポイントから状態を復元する
+		seオブジェクトはチェックポイントに保存されたl、r、θ₀で初期化し直される
+		\param cp 復元するチェックポイント
+	*/
+	DLLEXPORT void __stdcall restore(solveeom::SolveEoM::Checkpoint const * cp);
+
+	//! A global function.
+	/*!
+		現在の状態をチェックポイントファイルに保存する
+		\param filename 保存ファイル名
+		\return 保存に成功したかどうか
+	*/
+	DLLEXPORT bool __stdcall savecheckpoint(char const * filename);
+
+	//! A global function.
+	/*!
+		1回の呼び出しあたりの時間予算に対するsetter
+		0より大きい値を設定すると、nextstepは時間予算に収まるよう許容誤差と初期刻み値を自動で調整する
+		\param budget 時間予算（μs、0なら時間予算モードをやめる）
+	*/
+	DLLEXPORT void __stdcall setbudget(double budget);
+
+	//! A global function.
+	/*!
+		エネルギー収支を追跡するかどうかに対するsetter
+		\param isconsider_energy_budget エネルギー収支を追跡するかどうか
+	*/
+	DLLEXPORT void __stdcall setisconsider_energy_budget(bool isconsider_energy_budget);
+
+	//! A global function.
+	/*!
+		回転モードかどうかに対するsetter
+		\param isconsider_rotation 回転モードかどうか
+	*/
+	DLLEXPORT void __stdcall setisconsider_rotation(bool isconsider_rotation);
+
 	//! A global function.
 	/*!
 		慣性抵抗を考慮するかどうかに対するsetter
@@ -100,6 +223,13 @@ extern "C" {
 	*/
 	DLLEXPORT void __stdcall setisconsider_inertial_resistance(bool isconsider_inertial_resistance);
 
+	//! A global function.
+	/*!
+		多重振り子で慣性抵抗を考慮するかどうかに対するsetter
+		\param isconsider_inertial_resistance 慣性抵抗を考慮するかどうか
+	*/
+	DLLEXPORT void __stdcall setisconsider_inertial_resistancechain(bool isconsider_inertial_resistance);
+
 	//! A global function.
     /*!
         角度θの値に対するsetter
@@ -107,6 +237,13 @@ extern "C" {
     */
     DLLEXPORT void __stdcall settheta(float theta);
 
+	//! A global function.
+	/*!
+		多重振り子の各角度θに対するsetter
+		\param theta 設定する角度θ（要素数は振り子の数以上）
+	*/
+	DLLEXPORT void __stdcall setthetachain(float const * theta);
+
 	//! A global function.
 	/*!
 		初期角度θ₀の値に対するsetter
@@ -128,6 +265,50 @@ extern "C" {
 	*/
 	DLLEXPORT void __stdcall setv(float v);
 
+	//! A global function.
+	/*!
+		多重振り子の各球のひとつ上の球に対する相対的な速度vに対するsetter
+		\param v 設定する速度v（要素数は振り子の数以上）
+	*/
+	DLLEXPORT void __stdcall setvchain(float const * v);
+
+	//! A global function.
+	/*!
+		init、nextstep、settheta、setvなどの状態を変える呼び出し（多重振り子の呼び出しを含む）のトレースファイルへの記録を始める
+		seオブジェクトが初期化済みなら、最初に現在の状態をチェックポイントとして記録する
+		多重振り子の状態は記録しないので、多重振り子の呼び出しを再生するには、initchainから記録しなければならない
+		\param filename トレースファイル名
+		\return トレースファイルを作成できたかどうか
+	*/
+	DLLEXPORT bool __stdcall starttrace(char const * filename);
+
+	//! A global function.
+	/*!
+		トレースファイルへの記録を終え、ファイルを閉じる
+	*/
+	DLLEXPORT void __stdcall stoptrace();
+
+	//! A global function.
+	/*!
+		現在の状態から時間間隔dtごとにn個の角度θと速度vを求め、呼び出し側の配列に書き込む
+		\param theta 角度θの書き込み先（要素数n以上）
+		\param v 速度vの書き込み先（要素数n以上、nullptrなら書き込まない）
+		\param n 要素数
+		\param dt 時間間隔
+	*/
+	DLLEXPORT void __stdcall tabulate(float * theta, float * v, std::int32_t n, float dt);
+
+	//! A global function.
+	/*!
+		@fumofumobunさんの近似関数によって、時刻t0から時間間隔dtごとにn個の角度θと速度vを求め、呼び出し側の配列に書き込む
+		\param theta 角度θの書き込み先（要素数n以上）
+		\param v 速度vの書き込み先（要素数n以上、nullptrなら書き込まない）
+		\param n 要素数
+		\param t0 最初の要素の時刻
+		\param dt 時間間隔
+	*/
+	DLLEXPORT void __stdcall tabulate_fumofumobun_approx(float * theta, float * v, std::int32_t n, float t0, float dt);
+
 	//! A global function.
 	/*!
 		経過時間tを初期値（= 0.0）に戻す
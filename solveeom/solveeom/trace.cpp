@@ -0,0 +1,60 @@
+﻿/*! \file trace.cpp
+    \brief APIの呼び出し列をバイナリ形式で記録・再生するクラスの実装
+
+    Copyright © 2016-2018 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+#include "trace.h"
+
+namespace solveeom {
+    // #region コンストラクタ・デストラクタ
+
+    TraceWriter::TraceWriter(std::string const & filename) :
+        ofs_(filename, std::ios::binary | std::ios::trunc)
+    {
+        ofs_.write(reinterpret_cast<char const *>(&TRACE_MAGIC), sizeof(TRACE_MAGIC));
+        ofs_.write(reinterpret_cast<char const *>(&TRACE_VERSION), sizeof(TRACE_VERSION));
+    }
+
+    TraceReader::TraceReader(std::string const & filename) :
+        ifs_(filename, std::ios::binary)
+    {
+        std::uint32_t magic, version;
+        if (read(magic) && read(version)) {
+            good_ = magic == TRACE_MAGIC && version == TRACE_VERSION;
+        }
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region publicメンバ関数
+
+    bool TraceWriter::good() const
+    {
+        return static_cast<bool>(ofs_);
+    }
+
+    void TraceWriter::write(TraceOpcode op)
+    {
+        ofs_.put(static_cast<char>(op));
+    }
+
+    bool TraceReader::good() const
+    {
+        return good_;
+    }
+
+    bool TraceReader::readopcode(TraceOpcode & op)
+    {
+        auto const c = ifs_.get();
+        if (c == std::ifstream::traits_type::eof()) {
+            return false;
+        }
+
+        op = static_cast<TraceOpcode>(c);
+
+        return true;
+    }
+
+    // #endregion publicメンバ関数
+}
@@ -0,0 +1,319 @@
+﻿/*! \file trace.h
+    \brief APIの呼び出し列をバイナリ形式で記録・再生するクラスの宣言
+
+    Copyright © 2016-2018 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#pragma once
+
+#include <cstddef>                      // for std::size_t
+#include <cstdint>                      // for std::int32_t, std::uint8_t, std::uint32_t
+#include <fstream>                      // for std::ifstream, std::ofstream
+#include <string>                       // for std::string
+#include <type_traits>                  // for std::is_trivially_copyable_v
+
+namespace solveeom {
+    //!  A enumerated type
+    /*!
+        トレースに記録するAPI呼び出しの種類
+        各レコードは1バイトの種類と、それに続く引数からなる
+        引数は種類ごとに固定長だが、多重振り子の配列の引数だけは、先頭に要素数（std::int32_t）を置いた可変長とする
+        多重振り子はチェックポイントを持たないので、記録を途中から始めたときは、最初のinitchainより前の多重振り子の呼び出しは再生されない
+    */
+    enum class TraceOpcode : std::uint8_t {
+        // init(l, r, θ₀)（引数はfloat×3）
+        INIT = 0,
+        // nextstep(dt)（引数はfloat）
+        NEXTSTEP = 1,
+        // settheta(θ)（引数はfloat）
+        SETTHETA = 2,
+        // setv(v)（引数はfloat）
+        SETV = 3,
+        // setisconsider_inertial_resistance(b)（引数はstd::uint8_t）
+        SETISCONSIDER_INERTIAL_RESISTANCE = 4,
+        // setisconsider_energy_budget(b)（引数はstd::uint8_t）
+        SETISCONSIDER_ENERGY_BUDGET = 5,
+        // setisconsider_rotation(b)（引数はstd::uint8_t）
+        SETISCONSIDER_ROTATION = 6,
+        // setbudget(budget)（引数はdouble）
+        SETBUDGET = 7,
+        // チェックポイントからの復元（引数はSolveEoM::Checkpoint）
+        RESTORE = 8,
+        // energybudgetreset()（引数なし）
+        ENERGYBUDGETRESET = 9,
+        // saveresult(dt, filename, t)（引数はdt、tのdouble×2。ファイル名は記録しない）
+        SAVERESULT = 10,
+        // settheta0(θ₀)（引数はfloat）
+        SETTHETA0 = 11,
+        // settime(dt)（引数はfloat）
+        SETTIME = 12,
+        // timereset()（引数なし）
+        TIMERESET = 13,
+        // initchain(n, l, r, θ₀)（引数はstd::int32_tのn、続いてl、r、θ₀の順にfloat×n×3）
+        INITCHAIN = 14,
+        // nextstepchain(dt)（引数はfloat）
+        NEXTSTEPCHAIN = 15,
+        // setthetachain(θ)（引数はstd::int32_tのn、続いてfloat×n）
+        SETTHETACHAIN = 16,
+        // setvchain(v)（引数はstd::int32_tのn、続いてfloat×n）
+        SETVCHAIN = 17,
+        // setisconsider_inertial_resistancechain(b)（引数はstd::uint8_t）
+        SETISCONSIDER_INERTIAL_RESISTANCECHAIN = 18
+    };
+
+    //! A class.
+    /*!
+        API呼び出し列をトレースファイルに記録するクラス
+    */
+    class TraceWriter final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            トレースファイルを作成し、ヘッダを書き込む
+            \param filename トレースファイル名
+        */
+        explicit TraceWriter(std::string const & filename);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ（未書き込みのレコードはここでファイルに書き出される）
+        */
+        ~TraceWriter() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        //! A public member function (const).
+        /*!
+            トレースファイルに書き込めているかどうかを返す
+            \return 書き込めているかどうか
+        */
+        bool good() const;
+
+        //! A public member function.
+        /*!
+            引数のないレコードを1つ書き込む
+            \param op API呼び出しの種類
+        */
+        void write(TraceOpcode op);
+
+        //! A public member function (template function).
+        /*!
+            レコードを1つ書き込む
+            \param op API呼び出しの種類
+            \param args 引数（opに対応する型でなければならない）
+        */
+        template <typename T>
+        void write(TraceOpcode op, T const & args);
+
+        //! A public member function (template function).
+        /*!
+            直前に書き込んだレコードに、可変長の引数の配列を続けて書き込む
+            \param args 配列の先頭へのポインタ
+            \param n 要素数
+        */
+        template <typename T>
+        void writearray(T const * args, std::int32_t n);
+
+        // #endregion publicメンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private member variable.
+        /*!
+            トレースファイルのストリーム
+        */
+        std::ofstream ofs_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        TraceWriter() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        TraceWriter(TraceWriter const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        TraceWriter & operator=(TraceWriter const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    //! A class.
+    /*!
+        トレースファイルからAPI呼び出し列を読み込むクラス
+    */
+    class TraceReader final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            トレースファイルを開き、ヘッダを検査する
+            \param filename トレースファイル名
+        */
+        explicit TraceReader(std::string const & filename);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~TraceReader() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        //! A public member function (const).
+        /*!
+            トレースファイルを正しく開けたかどうかを返す
+            \return 正しく開けたかどうか（ファイルが存在しないか、ヘッダが不正ならfalse）
+        */
+        bool good() const;
+
+        //! A public member function (template function).
+        /*!
+            レコードの引数を読み込む
+            \param args 引数の格納先（直前に読み込んだ種類に対応する型でなければならない）
+            \return 読み込めたかどうか
+        */
+        template <typename T>
+        bool read(T & args);
+
+        //! A public member function (template function).
+        /*!
+            可変長の引数の配列を読み込む
+            \param args 配列の格納先（要素数n以上）
+            \param n 要素数
+            \return 読み込めたかどうか
+        */
+        template <typename T>
+        bool readarray(T * args, std::int32_t n);
+
+        //! A public member function.
+        /*!
+            次のレコードの種類を読み込む
+            \param op 種類の格納先
+            \return 読み込めたかどうか（ファイルの終端ならfalse）
+        */
+        bool readopcode(TraceOpcode & op);
+
+        // #endregion publicメンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private member variable.
+        /*!
+            ヘッダが正しいかどうか
+        */
+        bool good_ = false;
+
+        //! A private member variable.
+        /*!
+            トレースファイルのストリーム
+        */
+        std::ifstream ifs_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        TraceReader() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        TraceReader(TraceReader const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        TraceReader & operator=(TraceReader const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    //! A global variable (constant expression).
+    /*!
+        トレースファイルのマジックナンバー（"SEOT"）
+    */
+    static std::uint32_t constexpr TRACE_MAGIC = 0x544F4553;
+
+    //! A global variable (constant expression).
+    /*!
+        トレースファイルのバージョン
+    */
+    static std::uint32_t constexpr TRACE_VERSION = 3;
+
+    // #region template関数の実装
+
+    template <typename T>
+    inline void TraceWriter::write(TraceOpcode op, T const & args)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+        ofs_.put(static_cast<char>(op));
+        ofs_.write(reinterpret_cast<char const *>(&args), sizeof(T));
+    }
+
+    template <typename T>
+    inline void TraceWriter::writearray(T const * args, std::int32_t n)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+        ofs_.write(reinterpret_cast<char const *>(args), sizeof(T) * static_cast<std::size_t>(n));
+    }
+
+    template <typename T>
+    inline bool TraceReader::read(T & args)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+        return static_cast<bool>(ifs_.read(reinterpret_cast<char *>(&args), sizeof(T)));
+    }
+
+    template <typename T>
+    inline bool TraceReader::readarray(T * args, std::int32_t n)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+        return static_cast<bool>(ifs_.read(reinterpret_cast<char *>(args), sizeof(T) * static_cast<std::size_t>(n)));
+    }
+
+    // #endregion template関数の実装
+}
+
+#endif  // _TRACE_H_
@@ -0,0 +1,267 @@
+﻿/*! \file solveeomallocmain.cpp
+    \brief ステップ計算でヒープ領域を確保しないことを確かめるメイン関数
+
+    Copyright © 2016-2018 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+#include "../solveeom/solveeommain.h"
+#include <array>                        // for std::array
+#include <atomic>                       // for std::atomic
+#include <cstddef>                      // for std::byte, std::size_t
+#include <cstdint>                      // for std::uintptr_t
+#include <cstdlib>                      // for std::free, std::malloc
+#include <iostream>                     // for std::cout
+#include <memory_resource>              // for std::pmr::monotonic_buffer_resource, std::pmr::null_memory_resource
+#include <new>                          // for std::align_val_t, std::bad_alloc
+#include <boost/format.hpp>             // for boost::format
+
+namespace solveeomalloc {
+    //! A struct.
+    /*!
+        ヒープ領域の確保が起きないことを確かめるモード
+    */
+    struct AllocMode final {
+        //! A public member variable.
+        /*!
+            モードの名前
+        */
+        char const * name;
+
+        //! A public member variable.
+        /*!
+            慣性抵抗を考慮するかどうか
+        */
+        bool isconsider_inertial_resistance;
+
+        //! A public member variable.
+        /*!
+            エネルギー収支を追跡するかどうか
+        */
+        bool isconsider_energy_budget;
+
+        //! A public member variable.
+        /*!
+            回転モードかどうか
+        */
+        bool isconsider_rotation;
+
+        //! A public member variable.
+        /*!
+            1回の呼び出しあたりの時間予算（μs、0なら時間予算モードにしない）
+        */
+        double budget;
+    };
+
+    //! A global variable (constant expression).
+    /*!
+        ヒープ領域の確保が起きないことを確かめるモードの一覧
+    */
+    static std::array<AllocMode, 6> constexpr ALLOC_MODES = { {
+        { "plain", false, false, false, 0.0 },
+        { "inertial", true, false, false, 0.0 },
+        { "energy budget", true, true, false, 0.0 },
+        { "rotation", true, false, true, 0.0 },
+        { "energy budget + rotation", true, true, true, 0.0 },
+        { "time budget", true, false, false, 5.0 }
+    } };
+
+    //! A global variable (constant expression).
+    /*!
+        ヒープ領域の確保を数えるnextstepの呼び出し回数
+    */
+    static auto constexpr ALLOC_STEPS = 1000;
+
+    //! A global variable (constant expression).
+    /*!
+        多重振り子に渡すアリーナの大きさ（バイト）
+    */
+    static auto constexpr CHAIN_ARENA_SIZE = 65536;
+
+    //! A global variable (constant expression).
+    /*!
+        ヒープ領域の確保を数える多重振り子の振り子の数
+    */
+    static auto constexpr CHAIN_N = 3;
+
+    //! A global variable (constant expression).
+    /*!
+        nextstepに渡す時間間隔
+    */
+    static auto constexpr DT = 0.01;
+
+    //! A global variable.
+    /*!
+        operator newが呼び出された回数
+    */
+    static std::atomic<std::size_t> allocations = 0;
+
+    //! A function.
+    /*!
+        各モードでnextstepを繰り返し呼び出し、その間にヒープ領域の確保が一度も起きないことを確かめる
+        多重振り子は呼び出し側のアリーナで構築し、構築も含めてヒープ領域を確保しないことを確かめる
+        \return 終了コード（全てのモードで確保が0回なら0）
+    */
+    int alloc();
+}
+
+// operator newの置き換えはプログラム全体に及ぶので、solveeomexeとは別の実行ファイルにしている
+
+//! A global function.
+/*!
+    ヒープ領域の確保を数えるために置き換えたoperator new
+    \param size 確保する大きさ
+    \return 確保した領域へのポインタ
+*/
+void * operator new(std::size_t size)
+{
+    ++solveeomalloc::allocations;
+
+    if (auto const p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+//! A global function.
+/*!
+    ヒープ領域の確保を数えるために置き換えたoperator new（アラインメント指定付き）
+    std::pmr::new_delete_resourceなどはこちらを呼び出すので、これも数えなければならない
+    \param size 確保する大きさ
+    \param alignment アラインメント
+    \return 確保した領域へのポインタ
+*/
+void * operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++solveeomalloc::allocations;
+
+    // 元のポインタを直前に保存できるよう、余分に確保してから境界に揃える
+    auto const align = static_cast<std::size_t>(alignment);
+    auto const p = std::malloc(size + align + sizeof(void *));
+    if (!p) {
+        throw std::bad_alloc();
+    }
+
+    auto const q = reinterpret_cast<void **>((reinterpret_cast<std::uintptr_t>(p) + sizeof(void *) + align - 1) & ~(align - 1));
+    q[-1] = p;
+
+    return q;
+}
+
+// GCCは、置き換えたoperator deleteの中でstd::freeを呼ぶと、operator newで確保した領域をfreeで解放しているとみなして
+// -Wmismatched-new-deleteを出す。ここではoperator new自身がstd::mallocで確保しているので、この組み合わせで正しい
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+//! A global function.
+/*!
+    置き換えたoperator newに対応するoperator delete
+    \param p 解放する領域へのポインタ
+*/
+void operator delete(void * p) noexcept
+{
+    std::free(p);
+}
+
+//! A global function.
+/*!
+    置き換えたoperator newに対応するoperator delete（大きさ付き）
+    \param p 解放する領域へのポインタ
+*/
+void operator delete(void * p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+//! A global function.
+/*!
+    置き換えたoperator new（アラインメント指定付き）に対応するoperator delete
+    \param p 解放する領域へのポインタ
+*/
+void operator delete(void * p, std::align_val_t) noexcept
+{
+    if (p) {
+        std::free(static_cast<void **>(p)[-1]);
+    }
+}
+
+//! A global function.
+/*!
+    置き換えたoperator new（アラインメント指定付き）に対応するoperator delete（大きさ付き）
+    \param p 解放する領域へのポインタ
+    \param alignment アラインメント
+*/
+void operator delete(void * p, std::size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(p, alignment);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+int main()
+{
+    return solveeomalloc::alloc();
+}
+
+namespace solveeomalloc {
+    int alloc()
+    {
+        auto failed = 0;
+
+        for (auto const & mode : ALLOC_MODES) {
+            init(1.0f, 0.05f, 1.047197551f);
+            setisconsider_inertial_resistance(mode.isconsider_inertial_resistance);
+            setisconsider_energy_budget(mode.isconsider_energy_budget);
+            setisconsider_rotation(mode.isconsider_rotation);
+            setbudget(mode.budget);
+
+            // 回転モードでは、振り子が支点の周りを回り続けるだけの速度を与える
+            setv(mode.isconsider_rotation ? 8.0f : 0.0f);
+
+            auto const before = allocations.load();
+            for (auto i = 0; i < ALLOC_STEPS; i++) {
+                nextstep(static_cast<float>(DT));
+            }
+            auto const count = allocations.load() - before;
+
+            if (count != 0) {
+                ++failed;
+            }
+
+            std::cout << boost::format("%s: %s (%d allocations in %d nextstep calls)\n")
+                % mode.name % (count == 0 ? "OK" : "FAILED") % count % ALLOC_STEPS;
+        }
+
+        // アリーナが足りなければ、上流のnull_memory_resourceがstd::bad_allocを投げる
+        static std::array<std::byte, CHAIN_ARENA_SIZE> buffer;
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+        std::array<float, CHAIN_N> const l = { 1.0f, 0.8f, 0.6f };
+        std::array<float, CHAIN_N> const r = { 0.05f, 0.04f, 0.03f };
+        std::array<float, CHAIN_N> const theta0 = { 1.047197551f, 0.523598776f, 0.0f };
+
+        auto const before = allocations.load();
+        {
+            solveeom::SolveChainEoM sce(CHAIN_N, l.data(), r.data(), theta0.data(), &arena);
+            sce.Isconsider_Inertial_Resistance = true;
+
+            for (auto i = 0; i < ALLOC_STEPS; i++) {
+                sce(static_cast<float>(DT));
+            }
+        }
+        auto const count = allocations.load() - before;
+
+        if (count != 0) {
+            ++failed;
+        }
+
+        std::cout << boost::format("chain in an arena: %s (%d allocations in construction and %d steps)\n")
+            % (count == 0 ? "OK" : "FAILED") % count % ALLOC_STEPS;
+
+        return failed == 0 ? 0 : 1;
+    }
+}
@@ -14,8 +14,91 @@ namespace Solveeomcs
     /// </summary>
     public sealed class SolveEoMcs
     {
+        #region 構造体
+
+        /// <summary>
+        /// 時間予算モードでの精度と計算時間
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        public struct Accuracy
+        {
+            /// <summary>
+            /// 1回の呼び出しあたりの時間予算（μs）
+            /// </summary>
+            public Double Budget;
+
+            /// <summary>
+            /// 直前の呼び出しに要した時間（μs）
+            /// </summary>
+            public Double Elapsed;
+
+            /// <summary>
+            /// 次の呼び出しで用いる許容誤差
+            /// </summary>
+            public Double Eps;
+
+            /// <summary>
+            /// 次の呼び出しで用いる初期刻み値
+            /// </summary>
+            public Double Dx;
+
+            /// <summary>
+            /// 直前の呼び出しの推定誤差（絶対誤差）
+            /// </summary>
+            public Double Error;
+        }
+
+        /// <summary>
+        /// エネルギー収支
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        public struct EnergyBudget
+        {
+            /// <summary>
+            /// 運動エネルギー
+            /// </summary>
+            public Double Kinetic;
+
+            /// <summary>
+            /// ポテンシャルエネルギー
+            /// </summary>
+            public Double Potential;
+
+            /// <summary>
+            /// 抵抗によって散逸したエネルギー
+            /// </summary>
+            public Double Dissipated;
+
+            /// <summary>
+            /// エネルギーのずれ
+            /// </summary>
+            public Double Drift;
+        }
+
+        #endregion 構造体
+
         #region メソッド
 
+        /// <summary>
+        /// 散逸エネルギーを0に戻し、現在の全エネルギーをエネルギー収支の基準にする
+        /// </summary>
+        [DllImport("solveeom", EntryPoint = "energybudgetreset")]
+        public static extern void EnergyBudgetReset();
+
+        /// <summary>
+        /// 時間予算モードでの精度と計算時間を求める
+        /// </summary>
+        /// <param name="ac">精度と計算時間</param>
+        [DllImport("solveeom", EntryPoint = "getaccuracy")]
+        public static extern void GetAccuracy(out Accuracy ac);
+
+        /// <summary>
+        /// 現在のエネルギー収支を求める
+        /// </summary>
+        /// <param name="eb">エネルギー収支</param>
+        [DllImport("solveeom", EntryPoint = "getenergybudget")]
+        public static extern void GetEnergyBudget(out EnergyBudget eb);
+
         /// <summary>
         /// 角度θの値に対するgetter
         /// </summary>
@@ -23,6 +106,13 @@ namespace Solveeomcs
         [DllImport("solveeom", EntryPoint = "gettheta")]
         public static extern Single GetTheta();
 
+        /// <summary>
+        /// 多重振り子の各角度θを配列に書き込む
+        /// </summary>
+        /// <param name="theta">角度θの書き込み先（要素数は振り子の数以上）</param>
+        [DllImport("solveeom", EntryPoint = "getthetachain")]
+        public static extern void GetThetaChain([Out] Single[] theta);
+
         /// <summary>
         /// @fumofumobunさんの近似関数によって、角度θを求める
         /// </summary>
@@ -37,6 +127,13 @@ namespace Solveeomcs
         [DllImport("solveeom", EntryPoint = "getv")]
         public static extern Single GetV();
 
+        /// <summary>
+        /// 多重振り子の各球のひとつ上の球に対する相対的な速度vを配列に書き込む
+        /// </summary>
+        /// <param name="v">速度vの書き込み先（要素数は振り子の数以上）</param>
+        [DllImport("solveeom", EntryPoint = "getvchain")]
+        public static extern void GetVChain([Out] Single[] v);
+
         /// <summary>
         /// @fumofumobunさんの近似関数によって、速度vを求める
         /// </summary>
@@ -44,6 +141,13 @@ namespace Solveeomcs
         [DllImport("solveeom", EntryPoint = "getv_fumofumobun_approx")]
         public static extern Single GetV_Fumofumobun_Approx();
 
+        /// <summary>
+        /// 回転数の値に対するgetter
+        /// </summary>
+        /// <returns>回転数（角度θ = GetTheta() + 2π×回転数）</returns>
+        [DllImport("solveeom", EntryPoint = "getwinding")]
+        public static extern Int64 GetWinding();
+
         /// <summary>
         /// seオブジェクトを初期化する
         /// </summary>
@@ -53,6 +157,27 @@ namespace Solveeomcs
         [DllImport("solveeom", EntryPoint = "init")]
         public static extern void Init(Single l, Single r, Single theta0);
 
+        /// <summary>
+        /// sceオブジェクト（多重振り子）を初期化する
+        /// </summary>
+        /// <param name="n">振り子の数</param>
+        /// <param name="l">各ロープの長さ（要素数n）</param>
+        /// <param name="r">各球の半径（要素数n）</param>
+        /// <param name="theta0">各角度θの初期値θ₀（要素数n）</param>
+        /// <returns>初期化に成功したかどうか（nが0以下か、長さか半径が0以下ならfalse。メモリを確保できなかったときもfalseで、それまでの多重振り子は破棄される）</returns>
+        [DllImport("solveeom", EntryPoint = "initchain")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern Boolean InitChain(Int32 n, Single[] l, Single[] r, Single[] theta0);
+
+        /// <summary>
+        /// チェックポイントファイルから状態を復元する
+        /// </summary>
+        /// <param name="filename">読み込むファイル名</param>
+        /// <returns>復元に成功したかどうか</returns>
+        [DllImport("solveeom", EntryPoint = "loadcheckpoint")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern Boolean LoadCheckpoint([MarshalAs(UnmanagedType.LPStr)] String filename);
+
         /// <summary>
         /// 運動エネルギーを求める
         /// </summary>
@@ -69,6 +194,13 @@ namespace Solveeomcs
         [DllImport("solveeom", EntryPoint = "nextstep")]
         public static extern Single NextStep(Single dt);
 
+        /// <summary>
+        /// 多重振り子の次のステップを計算する
+        /// </summary>
+        /// <param name="dt">前ステップからの経過時間</param>
+        [DllImport("solveeom", EntryPoint = "nextstepchain")]
+        public static extern void NextStepChain(Single dt);
+
         /// <summary>
         /// ポテンシャルエネルギーを求める
         /// </summary>
@@ -77,12 +209,49 @@ namespace Solveeomcs
         [DllImport("solveeom", EntryPoint = "potential_energy")]
         public static extern Single Potential_Energy(Double theta);
 
+        /// <summary>
+        /// 現在の状態をチェックポイントファイルに保存する
+        /// </summary>
+        /// <param name="filename">保存ファイル名</param>
+        /// <returns>保存に成功したかどうか</returns>
+        [DllImport("solveeom", EntryPoint = "savecheckpoint")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern Boolean SaveCheckpoint([MarshalAs(UnmanagedType.LPStr)] String filename);
+
+        /// <summary>
+        /// 1回の呼び出しあたりの時間予算に対するsetter
+        /// </summary>
+        /// <param name="budget">時間予算（μs、0なら時間予算モードをやめる）</param>
+        [DllImport("solveeom", EntryPoint = "setbudget")]
+        public static extern void SetBudget(Double budget);
+
+        /// <summary>
+        /// エネルギー収支を追跡するかどうかに対するsetter
+        /// </summary>
+        /// <param name="isconsiderEnergyBudget">エネルギー収支を追跡するかどうか</param>
+        [DllImport("solveeom", EntryPoint = "setisconsider_energy_budget")]
+        public static extern void SetIsconsider_Energy_Budget(Boolean isconsiderEnergyBudget);
+
+        /// <summary>
+        /// 回転モードかどうかに対するsetter
+        /// </summary>
+        /// <param name="isconsiderRotation">回転モードかどうか</param>
+        [DllImport("solveeom", EntryPoint = "setisconsider_rotation")]
+        public static extern void SetIsconsider_Rotation(Boolean isconsiderRotation);
+
         /// <summary>
         /// 慣性抵抗を考慮するかどうかに対するsetter
         /// </summary>
         /// <param name="isconsiderInertialResistance">慣性抵抗を考慮するかどうか</param>
         [DllImport("solveeom", EntryPoint = "setisconsider_inertial_resistance")]
         public static extern void SetIsconsider_Inertial_Resistance(Boolean isconsiderInertialResistance);
+
+        /// <summary>
+        /// 多重振り子で慣性抵抗を考慮するかどうかに対するsetter
+        /// </summary>
+        /// <param name="isconsiderInertialResistance">慣性抵抗を考慮するかどうか</param>
+        [DllImport("solveeom", EntryPoint = "setisconsider_inertial_resistancechain")]
+        public static extern void SetIsconsider_Inertial_ResistanceChain(Boolean isconsiderInertialResistance);
         
         /// <summary>
         /// 角度θの値に対するsetter
@@ -91,6 +260,13 @@ namespace Solveeomcs
         [DllImport("solveeom", EntryPoint = "settheta")]
         public static extern void SetTheta(Single theta);
 
+        /// <summary>
+        /// 多重振り子の各角度θに対するsetter
+        /// </summary>
+        /// <param name="theta">設定する角度θ（要素数は振り子の数以上）</param>
+        [DllImport("solveeom", EntryPoint = "setthetachain")]
+        public static extern void SetThetaChain(Single[] theta);
+
         /// <summary>
         /// 初期角度θ₀の値に対するsetter
         /// </summary>
@@ -112,6 +288,49 @@ namespace Solveeomcs
         [DllImport("solveeom", EntryPoint = "setv")]
         public static extern void SetV(Single v);
 
+        /// <summary>
+        /// 多重振り子の各球のひとつ上の球に対する相対的な速度vに対するsetter
+        /// </summary>
+        /// <param name="v">設定する速度v（要素数は振り子の数以上）</param>
+        [DllImport("solveeom", EntryPoint = "setvchain")]
+        public static extern void SetVChain(Single[] v);
+
+        /// <summary>
+        /// Init、NextStep、SetTheta、SetVなどの状態を変える呼び出しのトレースファイルへの記録を始める
+        /// </summary>
+        /// <param name="filename">トレースファイル名</param>
+        /// <returns>トレースファイルを作成できたかどうか</returns>
+        [DllImport("solveeom", EntryPoint = "starttrace")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern Boolean StartTrace([MarshalAs(UnmanagedType.LPStr)] String filename);
+
+        /// <summary>
+        /// トレースファイルへの記録を終え、ファイルを閉じる
+        /// </summary>
+        [DllImport("solveeom", EntryPoint = "stoptrace")]
+        public static extern void StopTrace();
+
+        /// <summary>
+        /// 現在の状態から時間間隔dtごとにn個の角度θと速度vを求め、配列に書き込む
+        /// </summary>
+        /// <param name="theta">角度θの書き込み先（要素数n以上）</param>
+        /// <param name="v">速度vの書き込み先（要素数n以上、nullなら書き込まない）</param>
+        /// <param name="n">要素数</param>
+        /// <param name="dt">時間間隔</param>
+        [DllImport("solveeom", EntryPoint = "tabulate")]
+        public static extern void Tabulate([Out] Single[] theta, [Out] Single[] v, Int32 n, Single dt);
+
+        /// <summary>
+        /// @fumofumobunさんの近似関数によって、時刻t0から時間間隔dtごとにn個の角度θと速度vを求め、配列に書き込む
+        /// </summary>
+        /// <param name="theta">角度θの書き込み先（要素数n以上）</param>
+        /// <param name="v">速度vの書き込み先（要素数n以上、nullなら書き込まない）</param>
+        /// <param name="n">要素数</param>
+        /// <param name="t0">最初の要素の時刻</param>
+        /// <param name="dt">時間間隔</param>
+        [DllImport("solveeom", EntryPoint = "tabulate_fumofumobun_approx")]
+        public static extern void Tabulate_Fumofumobun_Approx([Out] Single[] theta, [Out] Single[] v, Int32 n, Single t0, Single dt);
+
         /// <summary>
         /// 経過時間tを初期値（= 0.0）に戻す
         /// </summary>
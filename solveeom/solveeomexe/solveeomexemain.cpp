@@ -5,11 +5,720 @@
     This software is released under the BSD 2-Clause License.
 */
 #include "../solveeom/solveeommain.h"
+#include <algorithm>                    // for std::any_of, std::max, std::sort
+#include <array>                        // for std::array
+#include <chrono>                       // for std::chrono
+#include <cmath>                        // for std::fabs, std::log2
+#include <cstddef>                      // for std::size_t
+#include <cstdint>                      // for std::int64_t, std::uint8_t
+#include <cstdio>                       // for std::sscanf
+#include <fstream>                      // for std::ifstream, std::ofstream
+#include <iostream>                     // for std::cerr, std::cout
+#include <string>                       // for std::string, std::getline
+#include <utility>                      // for std::move
+#include <vector>                       // for std::vector
+#include <boost/format.hpp>             // for boost::format
 
-int main()
+namespace solveeomexe {
+    //! A struct.
+    /*!
+        基準軌道を求める条件
+    */
+    struct Config final {
+        //! A public member variable.
+        /*!
+            条件の名前（基準軌道のファイル名になる）
+        */
+        char const * name;
+
+        //! A public member variable.
+        /*!
+            ロープの長さ
+        */
+        float l;
+
+        //! A public member variable.
+        /*!
+            球の半径
+        */
+        float r;
+
+        //! A public member variable.
+        /*!
+            θの初期値
+        */
+        float theta0;
+
+        //! A public member variable.
+        /*!
+            慣性抵抗を考慮するかどうか
+        */
+        bool isconsider_inertial_resistance;
+    };
+
+    //! A struct.
+    /*!
+        軌道（時刻ごとの角度θと速度v）
+    */
+    struct Trajectory final {
+        //! A public member variable.
+        /*!
+            軌道の計算に要した時間（ミリ秒）
+        */
+        double elapsed;
+
+        //! A public member variable.
+        /*!
+            角度θ
+        */
+        std::vector<double> theta;
+
+        //! A public member variable.
+        /*!
+            速度v
+        */
+        std::vector<double> v;
+    };
+
+    //! A struct.
+    /*!
+        振幅の極値（折り返し点）
+    */
+    struct Peak final {
+        //! A public member variable.
+        /*!
+            極値をとる時刻
+        */
+        double t;
+
+        //! A public member variable.
+        /*!
+            極値（θまたはv）
+        */
+        double value;
+    };
+
+    //! A struct.
+    /*!
+        トレースから読み込んだAPI呼び出し1回分
+    */
+    struct Call final {
+        //! A public member variable.
+        /*!
+            API呼び出しの種類
+        */
+        solveeom::TraceOpcode op;
+
+        //! A public member variable.
+        /*!
+            floatの引数（init以外は先頭のみ用いる）
+        */
+        std::array<float, 3> f;
+
+        //! A public member variable.
+        /*!
+            doubleの引数（saveresult以外は先頭のみ用いる）
+        */
+        std::array<double, 2> d;
+
+        //! A public member variable.
+        /*!
+            boolの引数
+        */
+        bool b;
+
+        //! A public member variable.
+        /*!
+            チェックポイントの番号
+        */
+        std::size_t cp;
+
+        //! A public member variable.
+        /*!
+            多重振り子の配列の引数の番号（initchainではl、r、θ₀を続けて格納する）
+        */
+        std::size_t array;
+    };
+
+    //! A global variable (constant expression).
+    /*!
+        基準軌道の条件の一覧
+    */
+    static std::array<Config, 5> constexpr CONFIGS = { {
+        { "l1_r005_deg60_viscous", 1.0f, 0.05f, 1.047197551f, false },
+        { "l1_r005_deg60_inertial", 1.0f, 0.05f, 1.047197551f, true },
+        { "l05_r002_deg30_inertial", 0.5f, 0.02f, 0.523598776f, true },
+        { "l1_r001_deg90_inertial", 1.0f, 0.01f, 1.570796327f, true },
+        { "l2_r01_deg170_inertial", 2.0f, 0.1f, 2.967059728f, true }
+    } };
+
+    //! A global variable (constant expression).
+    /*!
+        基準軌道の時間間隔
+    */
+    static auto constexpr DT = 0.01;
+
+    //! A global variable (constant expression).
+    /*!
+        振幅の許容誤差（rad）
+    */
+    static auto constexpr AMPLITUDE_TOLERANCE = 1.0E-5;
+
+    //! A global variable (constant expression).
+    /*!
+        位相（折り返し点の時刻）の許容誤差（s）
+    */
+    static auto constexpr PHASE_TOLERANCE = 1.0E-4;
+
+    //! A global variable (constant expression).
+    /*!
+        基準軌道のディレクトリの既定値（solveeomexeのプロジェクトディレクトリからの相対パス）
+        基準軌道は、odeintで実装されていた元のビルドで求めたもの
+    */
+    static auto constexpr REFERENCE_DIR = "reference";
+
+    //! A global variable (constant expression).
+    /*!
+        速度vの振幅の許容誤差（m/s）
+    */
+    static auto constexpr V_AMPLITUDE_TOLERANCE = 1.0E-5;
+
+    //! A global variable (constant expression).
+    /*!
+        基準軌道の長さ（s）
+    */
+    static auto constexpr TIME = 30.0;
+
+    //! A global variable (constant expression).
+    /*!
+        レイテンシのヒストグラムの階級の数（2ⁿナノ秒ごと）
+    */
+    static auto constexpr HISTOGRAM_BINS = 32;
+
+    //! A global variable (constant expression).
+    /*!
+        ヒストグラムの棒の最大の長さ
+    */
+    static auto constexpr HISTOGRAM_WIDTH = 50;
+
+    //! A global variable (constant expression).
+    /*!
+        トレースに記録されるAPI呼び出しの名前（TraceOpcodeの順）
+    */
+    static std::array<char const *, 19> constexpr OPCODE_NAMES = {
+        "init", "nextstep", "settheta", "setv", "setisconsider_inertial_resistance",
+        "setisconsider_energy_budget", "setisconsider_rotation", "setbudget", "restore",
+        "energybudgetreset", "saveresult", "settheta0", "settime", "timereset",
+        "initchain", "nextstepchain", "setthetachain", "setvchain", "setisconsider_inertial_resistancechain"
+    };
+
+    //! A function.
+    /*!
+        与えられた条件で軌道を計算する
+        \param config 条件
+        \return 計算した軌道
+    */
+    Trajectory compute(Config const & config);
+
+    //! A function.
+    /*!
+        軌道から振幅の極値（θなら折り返し点）を求める
+        \param y 角度θまたは速度vの時系列
+        \return 振幅の極値の一覧
+    */
+    std::vector<Peak> peaks(std::vector<double> const & y);
+
+    //! A function.
+    /*!
+        基準軌道を読み込む
+        \param filename ファイル名
+        \param trajectory 読み込んだ軌道
+        \return 読み込みに成功したかどうか
+    */
+    bool read(std::string const & filename, Trajectory & trajectory);
+
+    //! A function.
+    /*!
+        トレースファイルのAPI呼び出しを全て読み込む
+        \param filename トレースファイル名
+        \param calls 読み込んだAPI呼び出し
+        \param checkpoints 読み込んだチェックポイント
+        \param arrays 読み込んだ多重振り子の配列の引数
+        \return 読み込みに成功したかどうか
+    */
+    bool readtrace(std::string const & filename, std::vector<Call> & calls, std::vector<solveeom::SolveEoM::Checkpoint> & checkpoints, std::vector<std::vector<float>> & arrays);
+
+    //! A function.
+    /*!
+        全ての条件の基準軌道を保存する
+        \param dir 保存先のディレクトリ
+        \return 終了コード
+    */
+    int record(std::string const & dir);
+
+    //! A function.
+    /*!
+        トレースファイルのAPI呼び出しをできるだけ速く再実行し、種類ごとにレイテンシのヒストグラムを出力する
+        \param filename トレースファイル名
+        \return 終了コード
+    */
+    int replay(std::string const & filename);
+
+    //! A function.
+    /*!
+        レイテンシの統計とヒストグラムを出力する
+        \param name API呼び出しの名前
+        \param latencies レイテンシ（ナノ秒、ソートされる）
+    */
+    void report(char const * name, std::vector<std::int64_t> & latencies);
+
+    //! A function.
+    /*!
+        全ての条件の軌道を計算し、基準軌道と位相、θの振幅、vの振幅の許容誤差で比較する
+        \param dir 基準軌道のディレクトリ
+        \return 終了コード（全て許容誤差内なら0）
+    */
+    int verify(std::string const & dir);
+}
+
+int main(int argc, char * argv[])
 {
+    if (argc == 3 && std::string(argv[1]) == "record") {
+        return solveeomexe::record(argv[2]);
+    }
+
+    if (argc == 2 && std::string(argv[1]) == "verify") {
+        return solveeomexe::verify(solveeomexe::REFERENCE_DIR);
+    }
+
+    if (argc == 3 && std::string(argv[1]) == "verify") {
+        return solveeomexe::verify(argv[2]);
+    }
+
+    if (argc == 3 && std::string(argv[1]) == "replay") {
+        return solveeomexe::replay(argv[2]);
+    }
+
     init(1.0f, 0.05f, 1.047197551f);
     saveresult(0.001, "deg_60.csv", 30.0);
 
     return 0;
 }
+
+namespace solveeomexe {
+    Trajectory compute(Config const & config)
+    {
+        init(config.l, config.r, config.theta0);
+        setisconsider_inertial_resistance(config.isconsider_inertial_resistance);
+
+        auto const n = static_cast<std::size_t>(TIME / DT + 0.5);
+
+        Trajectory trajectory;
+        trajectory.theta.reserve(n + 1);
+        trajectory.v.reserve(n + 1);
+        trajectory.theta.push_back(gettheta());
+        trajectory.v.push_back(getv());
+
+        auto const start = std::chrono::high_resolution_clock::now();
+        for (auto i = 0U; i < n; i++) {
+            trajectory.theta.push_back(nextstep(static_cast<float>(DT)));
+            trajectory.v.push_back(getv());
+        }
+        auto const end = std::chrono::high_resolution_clock::now();
+
+        trajectory.elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+        return trajectory;
+    }
+
+    std::vector<Peak> peaks(std::vector<double> const & y)
+    {
+        std::vector<Peak> result;
+
+        for (auto i = 1U; i + 1 < y.size(); i++) {
+            auto const y0 = y[i - 1];
+            auto const y1 = y[i];
+            auto const y2 = y[i + 1];
+
+            // |y|の極大（θなら折り返し点）
+            if ((y1 - y0) * (y2 - y1) >= 0.0 || std::fabs(y1) < std::fabs(y0)) {
+                continue;
+            }
+
+            // 3点を通る放物線の頂点で、極値の時刻と値を補間する
+            auto const denom = y0 - 2.0 * y1 + y2;
+            auto const delta = denom != 0.0 ? 0.5 * (y0 - y2) / denom : 0.0;
+
+            result.push_back({ (static_cast<double>(i) + delta) * DT, y1 - 0.25 * (y0 - y2) * delta });
+        }
+
+        return result;
+    }
+
+    bool read(std::string const & filename, Trajectory & trajectory)
+    {
+        std::ifstream ifs(filename);
+        if (!ifs) {
+            return false;
+        }
+
+        std::string line;
+        if (!std::getline(ifs, line) || std::sscanf(line.c_str(), "# elapsed %lf", &trajectory.elapsed) != 1) {
+            return false;
+        }
+
+        while (std::getline(ifs, line)) {
+            double t, theta, v;
+            if (std::sscanf(line.c_str(), "%lf, %lf, %lf", &t, &theta, &v) != 3) {
+                return false;
+            }
+
+            trajectory.theta.push_back(theta);
+            trajectory.v.push_back(v);
+        }
+
+        return true;
+    }
+
+    bool readtrace(std::string const & filename, std::vector<Call> & calls, std::vector<solveeom::SolveEoM::Checkpoint> & checkpoints, std::vector<std::vector<float>> & arrays)
+    {
+        solveeom::TraceReader reader(filename);
+        if (!reader.good()) {
+            return false;
+        }
+
+        solveeom::TraceOpcode op;
+        while (reader.readopcode(op)) {
+            Call call = {};
+            call.op = op;
+
+            auto ok = true;
+            switch (op) {
+            case solveeom::TraceOpcode::INIT:
+                ok = reader.read(call.f);
+                break;
+
+            case solveeom::TraceOpcode::NEXTSTEP:
+            case solveeom::TraceOpcode::SETTHETA:
+            case solveeom::TraceOpcode::SETV:
+            case solveeom::TraceOpcode::SETTHETA0:
+            case solveeom::TraceOpcode::SETTIME:
+            case solveeom::TraceOpcode::NEXTSTEPCHAIN:
+                ok = reader.read(call.f[0]);
+                break;
+
+            case solveeom::TraceOpcode::INITCHAIN:
+            case solveeom::TraceOpcode::SETTHETACHAIN:
+            case solveeom::TraceOpcode::SETVCHAIN:
+            {
+                std::int32_t n;
+                ok = reader.read(n) && n > 0;
+                if (ok) {
+                    // initchainはl、r、θ₀の3つの配列を続けて記録している
+                    std::vector<float> array(static_cast<std::size_t>(n) * (op == solveeom::TraceOpcode::INITCHAIN ? 3 : 1));
+                    ok = reader.readarray(array.data(), static_cast<std::int32_t>(array.size()));
+                    call.array = arrays.size();
+                    arrays.push_back(std::move(array));
+                }
+            }
+                break;
+
+            case solveeom::TraceOpcode::SETISCONSIDER_INERTIAL_RESISTANCE:
+            case solveeom::TraceOpcode::SETISCONSIDER_ENERGY_BUDGET:
+            case solveeom::TraceOpcode::SETISCONSIDER_ROTATION:
+            case solveeom::TraceOpcode::SETISCONSIDER_INERTIAL_RESISTANCECHAIN:
+            {
+                std::uint8_t b;
+                ok = reader.read(b);
+                call.b = b != 0;
+            }
+                break;
+
+            case solveeom::TraceOpcode::SETBUDGET:
+                ok = reader.read(call.d[0]);
+                break;
+
+            case solveeom::TraceOpcode::SAVERESULT:
+                ok = reader.read(call.d);
+                break;
+
+            case solveeom::TraceOpcode::ENERGYBUDGETRESET:
+            case solveeom::TraceOpcode::TIMERESET:
+                break;
+
+            case solveeom::TraceOpcode::RESTORE:
+            {
+                // TRACE_VERSIONはチェックポイントのレイアウトまでは表さないので、チェックポイント自身のヘッダも検査する
+                solveeom::SolveEoM::Checkpoint cp;
+                ok = reader.read(cp) && solveeom::SolveEoM::isvalid(cp);
+                call.cp = checkpoints.size();
+                checkpoints.push_back(cp);
+            }
+                break;
+
+            default:
+                ok = false;
+                break;
+            }
+
+            if (!ok) {
+                return false;
+            }
+
+            calls.push_back(call);
+        }
+
+        return true;
+    }
+
+    int record(std::string const & dir)
+    {
+        for (auto const & config : CONFIGS) {
+            auto const trajectory = compute(config);
+
+            std::ofstream result(dir + "/" + config.name + ".csv");
+            result << boost::format("# elapsed %.3f\n") % trajectory.elapsed;
+            for (auto i = 0U; i < trajectory.theta.size(); i++) {
+                result << boost::format("%.3f, %.9e, %.9e\n") % (i * DT) % trajectory.theta[i] % trajectory.v[i];
+            }
+
+            std::cout << boost::format("%s: recorded (%.3f ms)\n") % config.name % trajectory.elapsed;
+        }
+
+        return 0;
+    }
+
+    int replay(std::string const & filename)
+    {
+        // ファイルの読み込みがレイテンシに混ざらないよう、先に全て読み込んでおく
+        std::vector<Call> calls;
+        std::vector<solveeom::SolveEoM::Checkpoint> checkpoints;
+        std::vector<std::vector<float>> arrays;
+        if (!readtrace(filename, calls, checkpoints, arrays)) {
+            std::cerr << boost::format("%s: cannot read the trace\n") % filename;
+            return 1;
+        }
+
+        // 時間予算モードでは、許容誤差と初期刻み値を再生するマシンでの計算時間から調整し直すので、記録時の状態を再現できない
+        auto const isbudget = std::any_of(calls.begin(), calls.end(), [&checkpoints](auto const & call) {
+            return (call.op == solveeom::TraceOpcode::SETBUDGET && call.d[0] > 0.0) ||
+                   (call.op == solveeom::TraceOpcode::RESTORE && checkpoints[call.cp].budget > 0.0);
+        });
+
+        std::array<std::vector<std::int64_t>, OPCODE_NAMES.size()> latencies;
+
+        // 再生後の多重振り子の状態を出力できるよう、最後にinitchainした振り子の数を覚えておく
+        auto chainn = 0;
+
+        auto const start = std::chrono::steady_clock::now();
+        for (auto i = 0U; i < calls.size(); i++) {
+            auto const & call = calls[i];
+
+            // saveresultの出力は、記録時のファイルを上書きしないよう、レコードの番号を付けてトレースファイルの隣に書き出す
+            auto const result = call.op == solveeom::TraceOpcode::SAVERESULT ?
+                (boost::format("%s.saveresult.%d.csv") % filename % i).str() : std::string();
+
+            auto const begin = std::chrono::steady_clock::now();
+
+            switch (call.op) {
+            case solveeom::TraceOpcode::INIT:
+                init(call.f[0], call.f[1], call.f[2]);
+                break;
+
+            case solveeom::TraceOpcode::NEXTSTEP:
+                nextstep(call.f[0]);
+                break;
+
+            case solveeom::TraceOpcode::SETTHETA:
+                settheta(call.f[0]);
+                break;
+
+            case solveeom::TraceOpcode::SETV:
+                setv(call.f[0]);
+                break;
+
+            case solveeom::TraceOpcode::SETISCONSIDER_INERTIAL_RESISTANCE:
+                setisconsider_inertial_resistance(call.b);
+                break;
+
+            case solveeom::TraceOpcode::SETISCONSIDER_ENERGY_BUDGET:
+                setisconsider_energy_budget(call.b);
+                break;
+
+            case solveeom::TraceOpcode::SETISCONSIDER_ROTATION:
+                setisconsider_rotation(call.b);
+                break;
+
+            case solveeom::TraceOpcode::SETBUDGET:
+                setbudget(call.d[0]);
+                break;
+
+            case solveeom::TraceOpcode::RESTORE:
+                restore(&checkpoints[call.cp]);
+                break;
+
+            case solveeom::TraceOpcode::ENERGYBUDGETRESET:
+                energybudgetreset();
+                break;
+
+            case solveeom::TraceOpcode::SAVERESULT:
+                saveresult(call.d[0], result, call.d[1]);
+                break;
+
+            case solveeom::TraceOpcode::SETTHETA0:
+                settheta0(call.f[0]);
+                break;
+
+            case solveeom::TraceOpcode::SETTIME:
+                settime(call.f[0]);
+                break;
+
+            case solveeom::TraceOpcode::TIMERESET:
+                timereset();
+                break;
+
+            case solveeom::TraceOpcode::INITCHAIN:
+            {
+                auto const & a = arrays[call.array];
+                auto const n = static_cast<std::int32_t>(a.size() / 3);
+                if (initchain(n, a.data(), a.data() + n, a.data() + 2 * n)) {
+                    chainn = n;
+                }
+            }
+                break;
+
+            case solveeom::TraceOpcode::NEXTSTEPCHAIN:
+                nextstepchain(call.f[0]);
+                break;
+
+            case solveeom::TraceOpcode::SETTHETACHAIN:
+                setthetachain(arrays[call.array].data());
+                break;
+
+            case solveeom::TraceOpcode::SETVCHAIN:
+                setvchain(arrays[call.array].data());
+                break;
+
+            case solveeom::TraceOpcode::SETISCONSIDER_INERTIAL_RESISTANCECHAIN:
+                setisconsider_inertial_resistancechain(call.b);
+                break;
+            }
+
+            auto const end = std::chrono::steady_clock::now();
+            latencies[static_cast<std::size_t>(call.op)].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+        }
+        auto const total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << boost::format("%s: %d calls replayed in %.3f ms\n") % filename % calls.size() % total;
+
+        // 記録時の最終状態と比べられるよう、再生後の状態を出力する
+        if (!latencies[static_cast<std::size_t>(solveeom::TraceOpcode::INIT)].empty() ||
+            !latencies[static_cast<std::size_t>(solveeom::TraceOpcode::RESTORE)].empty()) {
+            std::cout << boost::format("final state: theta = %.9f, v = %.9f\n") % gettheta() % getv();
+            if (isbudget) {
+                std::cout << "warning: the trace uses the time budget mode, so the final state is not reproducible\n";
+            }
+        }
+        if (chainn > 0) {
+            std::vector<float> theta(static_cast<std::size_t>(chainn));
+            getthetachain(theta.data());
+
+            std::cout << "final chain state: theta =";
+            for (auto const t : theta) {
+                std::cout << boost::format(" %.9f") % t;
+            }
+            std::cout << '\n';
+        }
+        for (auto i = 0U; i < latencies.size(); i++) {
+            if (!latencies[i].empty()) {
+                report(OPCODE_NAMES[i], latencies[i]);
+            }
+        }
+
+        return 0;
+    }
+
+    void report(char const * name, std::vector<std::int64_t> & latencies)
+    {
+        std::sort(latencies.begin(), latencies.end());
+
+        auto const percentile = [&latencies](double p) {
+            auto const i = static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1) + 0.5);
+            return static_cast<double>(latencies[i]) * 1.0E-3;
+        };
+
+        auto sum = 0.0;
+        for (auto const latency : latencies) {
+            sum += static_cast<double>(latency);
+        }
+
+        std::cout << boost::format("\n%s: %d calls, mean %.3f us, p50 %.3f us, p90 %.3f us, p99 %.3f us, p99.9 %.3f us, max %.3f us\n")
+            % name % latencies.size() % (sum / static_cast<double>(latencies.size()) * 1.0E-3)
+            % percentile(0.5) % percentile(0.9) % percentile(0.99) % percentile(0.999) % (static_cast<double>(latencies.back()) * 1.0E-3);
+
+        // 2ⁿナノ秒ごとの階級に分ける
+        std::array<std::size_t, HISTOGRAM_BINS> histogram = {};
+        for (auto const latency : latencies) {
+            auto const bin = latency > 0 ? static_cast<int>(std::log2(static_cast<double>(latency))) : 0;
+            ++histogram[std::min(bin, HISTOGRAM_BINS - 1)];
+        }
+
+        auto const peak = *std::max_element(histogram.begin(), histogram.end());
+        for (auto i = 0; i < HISTOGRAM_BINS; i++) {
+            if (histogram[i] == 0) {
+                continue;
+            }
+
+            auto const width = static_cast<int>(HISTOGRAM_WIDTH * histogram[i] / peak);
+            std::cout << boost::format("  [%10.3f, %10.3f) us %10d %s\n")
+                % (std::ldexp(1.0, i) * 1.0E-3) % (std::ldexp(1.0, i + 1) * 1.0E-3) % histogram[i] % std::string(std::max(width, 1), '#');
+        }
+    }
+
+    int verify(std::string const & dir)
+    {
+        auto failed = 0;
+
+        for (auto const & config : CONFIGS) {
+            Trajectory reference;
+            if (!read(dir + "/" + config.name + ".csv", reference)) {
+                std::cerr << boost::format("%s: cannot read the reference trajectory\n") % config.name;
+                ++failed;
+                continue;
+            }
+
+            auto const trajectory = compute(config);
+
+            auto const p = peaks(trajectory.theta);
+            auto const pref = peaks(reference.theta);
+
+            auto phase = 0.0;
+            auto amplitude = 0.0;
+            for (auto i = 0U; i < std::min(p.size(), pref.size()); i++) {
+                phase = std::max(phase, std::fabs(p[i].t - pref[i].t));
+                amplitude = std::max(amplitude, std::fabs(p[i].value - pref[i].value));
+            }
+
+            // vの極値（最下点の通過）の大きさも比べる
+            auto const vp = peaks(trajectory.v);
+            auto const vpref = peaks(reference.v);
+
+            auto vamplitude = 0.0;
+            for (auto i = 0U; i < std::min(vp.size(), vpref.size()); i++) {
+                vamplitude = std::max(vamplitude, std::fabs(vp[i].value - vpref[i].value));
+            }
+
+            auto const ok = p.size() == pref.size() && vp.size() == vpref.size() &&
+                phase <= PHASE_TOLERANCE && amplitude <= AMPLITUDE_TOLERANCE && vamplitude <= V_AMPLITUDE_TOLERANCE;
+            if (!ok) {
+                ++failed;
+            }
+
+            std::cout << boost::format("%s: %s (peaks %d/%d, phase %.3e s, amplitude %.3e rad, v amplitude %.3e m/s, %.3f ms / reference %.3f ms = %.2fx)\n")
+                % config.name % (ok ? "OK" : "FAILED") % p.size() % pref.size() % phase % amplitude % vamplitude
+                % trajectory.elapsed % reference.elapsed % (trajectory.elapsed / reference.elapsed);
+        }
+
+        return failed == 0 ? 0 : 1;
+    }
+}